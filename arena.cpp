@@ -0,0 +1,99 @@
+#include "arena.h"
+#include <stdint.h>
+#include <string.h>
+
+// Blocos novos dobram de tamanho até este limite
+static const size_t MAX_CHUNK_SIZE = 4 * 1024 * 1024;
+
+Arena::Arena(size_t firstChunkSize)
+    : current(0), pos(NULL), end(NULL), nextSize(firstChunkSize), used(0), peak(0) {}
+
+Arena::~Arena() {
+    for (const Chunk& c : chunks) {
+        delete[] c.data;
+    }
+}
+
+static char* alignUp(char* p, size_t align) {
+    uintptr_t v = (uintptr_t)p;
+    return (char*)((v + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void* Arena::allocate(size_t size, size_t align) {
+    char* start = alignUp(pos, align);
+    if (pos == NULL || start + size > end) {
+        return allocateSlow(size, align);
+    }
+    used += (size_t)(start + size - pos);
+    if (used > peak) peak = used;
+    pos = start + size;
+    return start;
+}
+
+void* Arena::allocateSlow(size_t size, size_t align) {
+    size_t needed = size + align;
+
+    // Depois de um reset/rewind, os blocos seguintes já existem
+    size_t next = pos == NULL ? 0 : current + 1;
+    while (next < chunks.size() && chunks[next].size < needed) {
+        next++;
+    }
+    if (next >= chunks.size()) {
+        size_t chunkSize = nextSize;
+        while (chunkSize < needed) chunkSize *= 2;
+        if (nextSize < MAX_CHUNK_SIZE) nextSize *= 2;
+
+        Chunk c;
+        c.data = new char[chunkSize];
+        c.size = chunkSize;
+        chunks.push_back(c);
+        next = chunks.size() - 1;
+    } else if (next > current + 1 && pos != NULL) {
+        // Pula blocos pequenos demais: eles ficam para depois do próximo reset
+        std::swap(chunks[current + 1], chunks[next]);
+        next = current + 1;
+    }
+
+    if (pos != NULL) {
+        used += (size_t)(end - pos);  // sobra do bloco anterior
+    }
+    current = next;
+    pos = chunks[current].data;
+    end = pos + chunks[current].size;
+    return allocate(size, align);
+}
+
+char* Arena::copyString(const char* text, size_t len) {
+    char* copy = (char*)allocate(len + 1, 1);
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+Arena::Mark Arena::mark() const {
+    Mark m;
+    m.chunk = current;
+    m.pos = pos;
+    m.used = used;
+    return m;
+}
+
+void Arena::rewind(const Mark& m) {
+    current = m.chunk;
+    pos = m.pos;
+    end = pos == NULL ? NULL : chunks[current].data + chunks[current].size;
+    used = m.used;
+}
+
+void Arena::reset() {
+    current = 0;
+    pos = NULL;
+    end = NULL;
+    used = 0;
+}
+
+size_t Arena::bytesReserved() const {
+    size_t total = 0;
+    for (const Chunk& c : chunks) total += c.size;
+    return total;
+}
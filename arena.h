@@ -0,0 +1,108 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Alocador por região (bump allocator) de uma compilação.
+ *
+ * Nós de expressão, texto de identificadores e literais, listas e
+ * vetores de comandos do AST saem daqui: cada alocação só avança um
+ * ponteiro dentro do bloco atual, e nada é liberado individualmente.
+ * reset() libera tudo de uma vez, mas mantém os blocos, de modo que a
+ * próxima compilação (ex.: várias entradas na linha de comando) reusa
+ * a mesma memória sem voltar ao malloc.
+ *
+ * Destrutores não são chamados: só objetos que não possuem memória
+ * fora da arena devem ser criados aqui.
+ */
+class Arena {
+public:
+    explicit Arena(size_t firstChunkSize = 16 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(max_align_t));
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Copia `len` bytes de `text` para a arena, com um NUL no fim.
+     */
+    char* copyString(const char* text, size_t len);
+
+    /**
+     * @brief Posição atual da arena; rewind() descarta tudo que foi
+     *        alocado depois dela.
+     */
+    struct Mark {
+        size_t chunk;
+        char* pos;
+        size_t used;
+    };
+    Mark mark() const;
+    void rewind(const Mark& m);
+
+    /**
+     * @brief Descarta todas as alocações (mantém os blocos para reuso).
+     */
+    void reset();
+
+    size_t bytesUsed() const { return used; }      // alocados desde o último reset
+    size_t peakBytes() const { return peak; }      // maior bytesUsed() já visto
+    size_t bytesReserved() const;                  // soma dos blocos
+    size_t chunkCount() const { return chunks.size(); }
+
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t current;      // índice do bloco em uso
+    char* pos;           // próximo byte livre no bloco atual
+    char* end;           // fim do bloco atual
+    size_t nextSize;     // tamanho do próximo bloco novo
+    size_t used;
+    size_t peak;
+
+    void* allocateSlow(size_t size, size_t align);
+};
+
+/**
+ * @brief Allocator de std para a Arena (deallocate não faz nada). Um
+ *        vetor que cresce deixa os buffers antigos na arena, o que no
+ *        máximo dobra o espaço dele.
+ */
+template <class T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena* a) : arena(a) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return (T*)arena->allocate(n * sizeof(T), alignof(T)); }
+    void deallocate(T*, size_t) {}
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // ARENA_H
@@ -0,0 +1,111 @@
+#include "ast.h"
+#include <stdio.h>
+#include <ostream>
+
+const char* binaryOpText(BinaryOp op) {
+    switch (op) {
+        case OP_MAIS:        return "+";
+        case OP_MENOS:       return "-";
+        case OP_VEZES:       return "*";
+        case OP_DIV:         return "/";
+        case OP_MENOR:       return "<";
+        case OP_MAIOR:       return ">";
+        case OP_MENOR_IGUAL: return "<=";
+        case OP_MAIOR_IGUAL: return ">=";
+        case OP_IGUAL_IGUAL: return "==";
+        case OP_DIFERENTE:   return "!=";
+    }
+    return "?";
+}
+
+/**
+ * @brief Pilha da espinha esquerda: as primeiras entradas ficam na
+ *        própria pilha de execução, só cadeias longas vão para o heap.
+ */
+class SpineStack {
+public:
+    SpineStack() : count(0) {}
+
+    void push(const Expr* e) {
+        if (count < LOCAL) local[count] = e;
+        else more.push_back(e);
+        count++;
+    }
+    const Expr* pop() {
+        count--;
+        if (count < LOCAL) return local[count];
+        const Expr* e = more.back();
+        more.pop_back();
+        return e;
+    }
+    size_t size() const { return count; }
+
+private:
+    static const size_t LOCAL = 32;
+    const Expr* local[LOCAL];
+    std::vector<const Expr*> more;
+    size_t count;
+};
+
+static void put(std::string& out, std::string_view text) { out += text; }
+static void put(std::ostream& out, std::string_view text) { out << text; }
+
+/**
+ * @brief Escreve o texto de `e` em `out`. Cadeias como a+b+c+... geram
+ *        árvores profundas à esquerda, então a espinha esquerda é
+ *        percorrida com a pilha explícita `spine` (compartilhada pelas
+ *        chamadas recursivas, que só descem pelos operandos direitos).
+ */
+template <class Out>
+static void appendExpr(Out& out, const Expr* e, const ASTProgram& program, SpineStack& spine) {
+    size_t base = spine.size();
+    while (e->kind == EXPR_BINARIA || e->kind == EXPR_PARENTESES) {
+        spine.push(e);
+        put(out, "(");
+        e = e->left;
+    }
+
+    switch (e->kind) {
+        case EXPR_NUMERO: {
+            // Negativos só vêm da dobra de constantes: "(-5)", para que
+            // "a - -5" não vire "a--5"
+            char buffer[16];
+            int n = snprintf(buffer, sizeof(buffer), e->value < 0 ? "(%d)" : "%d", e->value);
+            put(out, std::string_view(buffer, n));
+            break;
+        }
+        case EXPR_IDENT:
+            put(out, program.names.name(e->symbol));
+            break;
+        case EXPR_TEXTO:
+            put(out, program.literals.name(e->symbol));
+            break;
+        default:
+            break;
+    }
+
+    while (spine.size() > base) {
+        const Expr* node = spine.pop();
+        if (node->kind == EXPR_BINARIA) {
+            put(out, binaryOpText(node->op));
+            appendExpr(out, node->right, program, spine);
+        }
+        put(out, ")");
+    }
+}
+
+std::string exprText(const Expr* e, const ASTProgram& program) {
+    std::string text;
+    if (e != NULL) {
+        SpineStack spine;
+        appendExpr(text, e, program, spine);
+    }
+    return text;
+}
+
+void printExpr(std::ostream& out, const Expr* e, const ASTProgram& program) {
+    if (e != NULL) {
+        SpineStack spine;
+        appendExpr(out, e, program, spine);
+    }
+}
@@ -1,33 +1,31 @@
 #ifndef AST_H
 #define AST_H
 
+#include <iosfwd>
 #include <string>
 #include <vector>
+#include "arena.h"
+#include "interner.h"
+#include "symtab.h"
 
 /* -------------------------------------------------
- * 1) Tipo de variável
+ * 1) Tipo de variável e modo de pino: VarType e PinMode (symtab.h)
  * ------------------------------------------------- */
-enum VarType {
-    VAR_INTEIRO,
-    VAR_TEXTO,
-    VAR_BOOLEANO,
-    VAR_UNDEFINED
-};
 
 /* -------------------------------------------------
  * 2) Estrutura de Declaração de Variável
  * ------------------------------------------------- */
 struct VarDecl {
-    std::string name;   // nome da variável, ex. "ledPin"
+    SymbolId name;      // nome da variável, ex. "ledPin" (internado)
     VarType type;       // VAR_INTEIRO, VAR_TEXTO, etc.
 
     // Flags de contexto (úteis na análise semântica):
-    bool isPin;         // se foi configurada como pino (entrada/saída)
+    PinMode pinMode;    // se já é pino, e em que modo (PINO_NENHUM se não)
     bool isPWM;         // se foi configurada como PWM
-    std::string pinMode; // "saida", "entrada", etc.
+    int line;           // linha do "var" no fonte (para os diagnósticos)
 
     // Construtor padrão (inicializa flags)
-    VarDecl() : type(VAR_UNDEFINED), isPin(false), isPWM(false) {}
+    VarDecl() : name(NO_SYMBOL), type(VAR_UNDEFINED), pinMode(PINO_NENHUM), isPWM(false), line(0) {}
 };
 
 /* -------------------------------------------------
@@ -54,69 +52,291 @@ enum CmdType {
 };
 
 /* -------------------------------------------------
- * 4) Estrutura de Comando (Command)
+ * 4) Expressões
  * ------------------------------------------------- */
-struct Command {
-    CmdType cmdType;  // qual tipo de comando?
+enum ExprKind {
+    EXPR_NUMERO,      // ex.:  128
+    EXPR_IDENT,       // ex.:  brilho
+    EXPR_TEXTO,       // ex.:  "MinhaRede" (com as aspas)
+    EXPR_BINARIA,     // ex.:  brilho + 1
+    EXPR_PARENTESES   // ex.:  (20 * 2)
+};
 
-    // Campos genéricos. Nem todos serão usados em todo comando, 
-    // mas isso simplifica se você não quiser uma struct por comando
-    std::string varName;     // para assignment: ex.: "ledPin" ou lerDigital: ex.: "estadoBotao"
-    std::string expr;        // para assignment ou qualquer expression (ex.: "2", "brilho", "128", etc.)
+enum BinaryOp {
+    OP_MAIS, OP_MENOS, OP_VEZES, OP_DIV,
+    OP_MENOR, OP_MAIOR, OP_MENOR_IGUAL, OP_MAIOR_IGUAL,
+    OP_IGUAL_IGUAL, OP_DIFERENTE
+};
+
+/**
+ * @brief Nó de expressão. Os nós ficam na arena do ASTProgram (criados
+ *        com ASTProgram::newNumber(), newBinary(), etc.) e nunca são
+ *        liberados individualmente.
+ */
+struct Expr {
+    ExprKind kind;
+    BinaryOp op;       // EXPR_BINARIA
+    int value;         // EXPR_NUMERO
+    SymbolId symbol;   // EXPR_IDENT: nome; EXPR_TEXTO: ASTProgram::literals
+    Expr* left;        // EXPR_BINARIA e EXPR_PARENTESES
+    Expr* right;       // EXPR_BINARIA
 
-    // Para config pino
-    std::string pin;         // ex.: "ledPin"
-    std::string pinMode;     // "saida" ou "entrada"
+    // Tipo do nó, preenchido pela análise semântica (VAR_UNDEFINED antes
+    // dela, ou se o nó tem erro)
+    mutable VarType type;
 
-    // Para config PWM
-    int freq;                // ex.: 5000
-    int resol;               // ex.: 8
-    // Ajuste de PWM
-    std::string valueExpr;   // ex.: "brilho", "128", etc.
+    explicit Expr(ExprKind k) : kind(k), op(OP_MAIS), value(0), symbol(NO_SYMBOL),
+                                left(NULL), right(NULL), type(VAR_UNDEFINED) {}
+};
 
-    // Wi-Fi
-    std::string ssid;
-    std::string password;
+/* -------------------------------------------------
+ * 5) Comandos: um payload pequeno por CmdType
+ * ------------------------------------------------- */
+// Textos (URL, mensagens) são SymbolId de
+// ASTProgram::literals; nomes são SymbolId de ASTProgram::names.
 
-    // Esperar (delay)
-    std::string waitTime;    // ex.: "1000"
+/**
+ * @brief Índice de um sub-bloco (corpo de se/senão/enquanto) em
+ *        ASTProgram::blocks.
+ */
+typedef uint32_t BlockId;
 
-    // Ligar/Desligar
-    std::string digitalPin;  // ex.: "ledPin"
+const BlockId NO_BLOCK = 0xFFFFFFFFu;
 
-    // Envio HTTP
-    std::string httpUrl;
-    std::string httpData;
+struct AssignCmd {        // CMD_ASSIGN:          ledPin = 2;
+    SymbolId var;
+    Expr* value;
+};
 
-    // Serial
-    std::string serialMsg;
+struct ReadPinCmd {       // CMD_LER_DIGITAL / CMD_LER_ANALOGICO: estado = lerDigital botao;
+    SymbolId var;         // destino
+    SymbolId pin;
+};
 
-    // IF/WHILE (apenas exemplificando; se quiser sub-blocos, precisa vector<Command>)
-    std::string conditionExpr;
+struct ConfigPinCmd {     // CMD_CONFIG_PIN:      configurar ledPin como saida;
+    SymbolId pin;
+    PinMode mode;         // "saida" ou "entrada", resolvido pelo parser
+};
 
-    // Construtor default
-    Command() : cmdType(CMD_UNDEFINED), freq(0), resol(0) {}
+struct ConfigPwmCmd {     // CMD_CONFIG_PWM:      configurarPWM ledPin com frequencia 5000 resolucao 8;
+    SymbolId pin;
+    int freq;
+    int resol;
+};
+
+/**
+ * @brief Valor de um ajustarPWM frente à resolução do canal (ranges.h).
+ */
+enum DutyCheck : uint8_t {
+    DUTY_UNCHECKED,  // sem análise (o parser deixa assim): ledcWrite direto
+    DUTY_PROVEN,     // sempre em 0..2^resol-1: ledcWrite direto
+    DUTY_CLAMP,      // pode sair da faixa: o valor é limitado antes
+    DUTY_OVERFLOW    // sempre fora da faixa: erro de compilação
+};
+
+struct PwmAdjustCmd {     // CMD_PWM_ADJUST:      ajustarPWM ledPin com valor brilho;
+    SymbolId pin;
+    mutable DutyCheck duty;  // preenchido por ranges.cpp (entre pin e value: cabe no alinhamento)
+    Expr* value;
+};
+
+struct WifiCmd {          // CMD_WIFI_CONNECT:    conectarWifi ssid senha;
+    SymbolId ssid;
+    SymbolId password;
+};
+
+struct WaitCmd {          // CMD_WAIT:            esperar 1000;
+    Expr* time;
+};
+
+struct DigitalCmd {       // CMD_LIGAR / CMD_DESLIGAR: ligar ledPin;
+    SymbolId pin;
+};
+
+struct HttpCmd {          // CMD_ENVIAR_HTTP:     enviarHttp "url" "dados";
+    SymbolId url;         // com as aspas
+    SymbolId data;
+};
+
+struct SerialCmd {        // CMD_ESCREVER_SERIAL: escreverSerial "msg";
+    SymbolId msg;
+};
+
+struct CondCmd {          // CMD_IF / CMD_WHILE:  se expr entao ... [senao ...] fim
+    Expr* condition;
+    BlockId body;         // entao / corpo do enquanto
+    BlockId elseBody;     // senao (NO_BLOCK se não houver; sempre em CMD_WHILE)
+};
+
+/**
+ * @brief Comando: a tag `cmdType` diz qual membro da união vale.
+ *
+ * Cada comando ocupa só o maior payload (16 bytes) mais a tag e a
+ * linha (que cabem no alinhamento do payload), e é trivialmente
+ * copiável; os blocos são vetores contíguos de Command na arena,
+ * montados com emplace_back(tipo, payload, linha). CMD_LER_SERIAL não
+ * tem payload.
+ */
+struct Command {
+    CmdType cmdType;
+    int line;             // linha do primeiro token do comando (diagnósticos)
+    union {
+        AssignCmd assign;
+        ReadPinCmd readPin;
+        ConfigPinCmd configPin;
+        ConfigPwmCmd configPwm;
+        PwmAdjustCmd pwmAdjust;
+        WifiCmd wifi;
+        WaitCmd wait;
+        DigitalCmd digital;
+        HttpCmd http;
+        SerialCmd serial;
+        CondCmd cond;
+    };
+
+    Command(CmdType t, const AssignCmd& p, int l)    : cmdType(t), line(l), assign(p) {}
+    Command(CmdType t, const ReadPinCmd& p, int l)   : cmdType(t), line(l), readPin(p) {}
+    Command(CmdType t, const ConfigPinCmd& p, int l) : cmdType(t), line(l), configPin(p) {}
+    Command(CmdType t, const ConfigPwmCmd& p, int l) : cmdType(t), line(l), configPwm(p) {}
+    Command(CmdType t, const PwmAdjustCmd& p, int l) : cmdType(t), line(l), pwmAdjust(p) {}
+    Command(CmdType t, const WifiCmd& p, int l)      : cmdType(t), line(l), wifi(p) {}
+    Command(CmdType t, const WaitCmd& p, int l)      : cmdType(t), line(l), wait(p) {}
+    Command(CmdType t, const DigitalCmd& p, int l)   : cmdType(t), line(l), digital(p) {}
+    Command(CmdType t, const HttpCmd& p, int l)      : cmdType(t), line(l), http(p) {}
+    Command(CmdType t, const SerialCmd& p, int l)    : cmdType(t), line(l), serial(p) {}
+    Command(CmdType t, const CondCmd& p, int l)      : cmdType(t), line(l), cond(p) {}
 };
 
+/**
+ * @brief Sequência de comandos de um bloco (config, repita ou sub-bloco).
+ */
+typedef ArenaVector<Command> CommandList;
+
 /* -------------------------------------------------
- * 5) Estrutura principal do Programa
+ * 6) Estrutura principal do Programa
  * ------------------------------------------------- */
 struct ASTProgram {
+    // Memória de toda a compilação: nós, listas e vetores abaixo.
+    // Deve ser o primeiro membro (é destruída por último).
+    Arena arena;
+
+    // Texto dos nomes e literais internados. Fica fora de `arena` para
+    // que a compilação em streaming possa descartar os nós de um comando
+    // já gerado (Arena::rewind) sem perder os nomes que ele introduziu.
+    Arena textArena;
+
+    // Nomes internados (todos os SymbolId do programa apontam para cá)
+    StringInterner names;
+
+    // Literais de texto (strings com as aspas, "saida"/"entrada")
+    StringInterner literals;
+
     // Lista de variáveis declaradas
-    std::vector<VarDecl> declarations;
+    ArenaVector<VarDecl> declarations;
 
     // Bloco "config"
-    std::vector<Command> configCommands;
+    CommandList configCommands;
 
     // Bloco "repita" (loop principal)
-    std::vector<Command> repitaCommands;
+    CommandList repitaCommands;
+
+    // Sub-blocos de se/senão/enquanto, na ordem em que são abertos no
+    // fonte (CondCmd::body/elseBody indexam este vetor)
+    ArenaVector<CommandList> blocks;
 
-    // Se precisar de IF aninhado ou WHILE aninhado,
-    // pode guardar sub-blocos, mas isso é opcional 
-    // num design mais simples.
+    // Atributos de cada nome (tipo, PWM, ...), preenchidos pela análise
+    // semântica e lidos pela geração de código
+    SymbolTable symbols;
 
     // Construtor default
-    ASTProgram() {}
+    ASTProgram()
+        : names(textArena), literals(textArena),
+          declarations(ArenaAllocator<VarDecl>(&arena)),
+          configCommands(ArenaAllocator<Command>(&arena)),
+          repitaCommands(ArenaAllocator<Command>(&arena)),
+          blocks(ArenaAllocator<CommandList>(&arena)) {}
+
+    ASTProgram(const ASTProgram&) = delete;
+    ASTProgram& operator=(const ASTProgram&) = delete;
+
+    /**
+     * @brief Esvazia o programa e libera a arena de uma vez, mantendo os
+     *        blocos para a próxima compilação.
+     */
+    void clear() {
+        declarations = ArenaVector<VarDecl>(ArenaAllocator<VarDecl>(&arena));
+        configCommands = CommandList(ArenaAllocator<Command>(&arena));
+        repitaCommands = CommandList(ArenaAllocator<Command>(&arena));
+        clearBlocks();
+        names.clear();
+        literals.clear();
+        symbols.clear();
+        textArena.reset();
+        arena.reset();
+    }
+
+    /**
+     * @brief Esquece os sub-blocos (os BlockId voltam a começar do zero)
+     *        e solta o vetor, que pode então ser descartado por um
+     *        Arena::rewind.
+     */
+    void clearBlocks() {
+        blocks = ArenaVector<CommandList>(ArenaAllocator<CommandList>(&arena));
+    }
+
+    /**
+     * @brief Cria um sub-bloco vazio.
+     */
+    BlockId newBlock() {
+        blocks.emplace_back(ArenaAllocator<Command>(&arena));
+        return (BlockId)(blocks.size() - 1);
+    }
+    const CommandList& block(BlockId id) const { return blocks[id]; }
+
+    // Criação de nós de expressão
+    Expr* newNumber(int value) {
+        Expr* e = arena.create<Expr>(EXPR_NUMERO);
+        e->value = value;
+        return e;
+    }
+    Expr* newIdent(SymbolId name) {
+        Expr* e = arena.create<Expr>(EXPR_IDENT);
+        e->symbol = name;
+        return e;
+    }
+    Expr* newString(SymbolId literal) {
+        Expr* e = arena.create<Expr>(EXPR_TEXTO);
+        e->symbol = literal;
+        return e;
+    }
+    Expr* newBinary(BinaryOp op, Expr* left, Expr* right) {
+        Expr* e = arena.create<Expr>(EXPR_BINARIA);
+        e->op = op;
+        e->left = left;
+        e->right = right;
+        return e;
+    }
+    Expr* newParen(Expr* inner) {
+        Expr* e = arena.create<Expr>(EXPR_PARENTESES);
+        e->left = inner;
+        return e;
+    }
 };
 
+/**
+ * @brief Escreve a expressão como C++, totalmente parentizada (ex.:
+ *        "(100+((20*2)))"), em tempo linear no tamanho da árvore.
+ */
+void printExpr(std::ostream& out, const Expr* e, const ASTProgram& program);
+
+/**
+ * @brief O mesmo texto de printExpr, como string (trace e mensagens).
+ */
+std::string exprText(const Expr* e, const ASTProgram& program);
+
+/**
+ * @brief Texto do operador em C++ (ex.: OP_MENOR_IGUAL -> "<=").
+ */
+const char* binaryOpText(BinaryOp op);
+
 #endif // AST_H
@@ -0,0 +1,167 @@
+#include "cfg.h"
+#include "trace.h"
+#include <ostream>
+
+/**
+ * @brief Monta o CFG de um bloco de nível superior. Trabalha com
+ *        índices (e não referências) porque `blocks` cresce durante a
+ *        construção.
+ */
+class CfgBuilder {
+public:
+    CfgBuilder(const ASTProgram& p, ControlFlowGraph& g) : program(p), graph(g) {}
+
+    void build(const Command* begin, const Command* end) {
+        graph.entry = newBlock();
+        BasicBlockId last = lower(begin, end, graph.entry);
+        graph.exit = newBlock();
+        jump(last, graph.exit);
+    }
+
+private:
+    const ASTProgram& program;
+    ControlFlowGraph& graph;
+
+    BasicBlockId newBlock() {
+        BasicBlock b;
+        b.begin = b.end = NULL;
+        b.term = TERM_RETURN;
+        b.condition = NULL;
+        b.next = b.other = b.join = NO_BASIC_BLOCK;
+        b.origin = NULL;
+        graph.blocks.push_back(b);
+        return (BasicBlockId)(graph.blocks.size() - 1);
+    }
+
+    void jump(BasicBlockId from, BasicBlockId to) {
+        graph.blocks[from].term = TERM_JUMP;
+        graph.blocks[from].next = to;
+    }
+
+    BasicBlockId lower(const Command* first, const Command* end, BasicBlockId current);
+
+    BasicBlockId lower(const CommandList& list, BasicBlockId current) {
+        return lower(list.data(), list.data() + list.size(), current);
+    }
+};
+
+/**
+ * @brief Rebaixa [first, end) a partir do bloco vazio `current`.
+ * @return O bloco (ainda sem desvio) onde o controle segue após a lista.
+ */
+BasicBlockId CfgBuilder::lower(const Command* first, const Command* end, BasicBlockId current) {
+    const Command* run = first;  // início dos comandos em linha reta pendentes
+
+    for (const Command* c = first; c != end; ++c) {
+        if (c->cmdType != CMD_IF && c->cmdType != CMD_WHILE) continue;
+
+        // Fecha os comandos em linha reta no bloco atual
+        graph.blocks[current].begin = run;
+        graph.blocks[current].end = c;
+        run = c + 1;
+
+        const CondCmd& cond = c->cond;
+        if (c->cmdType == CMD_IF) {
+            BasicBlockId thenEntry = newBlock();
+            BasicBlockId thenExit = lower(program.block(cond.body), thenEntry);
+            BasicBlockId elseEntry = NO_BASIC_BLOCK, elseExit = NO_BASIC_BLOCK;
+            if (cond.elseBody != NO_BLOCK) {
+                elseEntry = newBlock();
+                elseExit = lower(program.block(cond.elseBody), elseEntry);
+            }
+            BasicBlockId join = newBlock();
+            jump(thenExit, join);
+            if (elseExit != NO_BASIC_BLOCK) jump(elseExit, join);
+
+            BasicBlock& b = graph.blocks[current];
+            b.term = TERM_BRANCH;
+            b.condition = cond.condition;
+            b.next = thenEntry;
+            b.other = elseEntry != NO_BASIC_BLOCK ? elseEntry : join;
+            b.origin = c;
+            b.join = join;
+            current = join;
+        } else {
+            // Cabeçalho próprio: é o alvo da aresta de volta do corpo
+            BasicBlockId header = newBlock();
+            jump(current, header);
+            BasicBlockId bodyEntry = newBlock();
+            BasicBlockId bodyExit = lower(program.block(cond.body), bodyEntry);
+            jump(bodyExit, header);
+            BasicBlockId exit = newBlock();
+
+            BasicBlock& h = graph.blocks[header];
+            h.term = TERM_BRANCH;
+            h.condition = cond.condition;
+            h.next = bodyEntry;
+            h.other = exit;
+            h.origin = c;
+            h.join = exit;
+            current = exit;
+        }
+    }
+
+    graph.blocks[current].begin = run;
+    graph.blocks[current].end = end;
+    return current;
+}
+
+void buildCfg(const ASTProgram& program, const CommandList& list, ControlFlowGraph& graph) {
+    CfgBuilder(program, graph).build(list.data(), list.data() + list.size());
+}
+
+void buildCfg(const ASTProgram& program, const Command* begin, const Command* end,
+              ControlFlowGraph& graph) {
+    CfgBuilder(program, graph).build(begin, end);
+}
+
+void buildProgramCfg(const ASTProgram& program, ProgramCfg& cfg) {
+    buildCfg(program, program.configCommands, cfg.setup);
+    buildCfg(program, program.repitaCommands, cfg.loop);
+    TRACE(TRACE_SEMANTIC, TRACE_INFO, "CFG: setup com %zu blocos, loop com %zu blocos",
+          cfg.setup.blocks.size(), cfg.loop.blocks.size());
+}
+
+static const char* cmdTypeName(CmdType type) {
+    switch (type) {
+        case CMD_ASSIGN:          return "atribuicao";
+        case CMD_CONFIG_PIN:      return "configurar";
+        case CMD_CONFIG_PWM:      return "configurarPWM";
+        case CMD_PWM_ADJUST:      return "ajustarPWM";
+        case CMD_WIFI_CONNECT:    return "conectarWifi";
+        case CMD_WAIT:            return "esperar";
+        case CMD_LIGAR:           return "ligar";
+        case CMD_DESLIGAR:        return "desligar";
+        case CMD_LER_DIGITAL:     return "lerDigital";
+        case CMD_LER_ANALOGICO:   return "lerAnalogico";
+        case CMD_ENVIAR_HTTP:     return "enviarHttp";
+        case CMD_ESCREVER_SERIAL: return "escreverSerial";
+        case CMD_LER_SERIAL:      return "lerSerial";
+        case CMD_IF:              return "se";
+        case CMD_WHILE:           return "enquanto";
+        default:                  return "?";
+    }
+}
+
+void printCfg(std::ostream& out, const ControlFlowGraph& graph, const ASTProgram& program) {
+    for (BasicBlockId id = 0; id < (BasicBlockId)graph.blocks.size(); id++) {
+        const BasicBlock& b = graph.blocks[id];
+        out << "  B" << id << ":";
+        for (const Command* c = b.begin; c != b.end; ++c) {
+            out << " " << cmdTypeName(c->cmdType);
+        }
+        switch (b.term) {
+            case TERM_JUMP:
+                out << " -> B" << b.next << "\n";
+                break;
+            case TERM_BRANCH:
+                out << " " << cmdTypeName(b.origin->cmdType) << " ";
+                printExpr(out, b.condition, program);
+                out << " ? B" << b.next << " : B" << b.other << "\n";
+                break;
+            case TERM_RETURN:
+                out << " fim\n";
+                break;
+        }
+    }
+}
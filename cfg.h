@@ -0,0 +1,110 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include <stdint.h>
+#include <iosfwd>
+#include "ast.h"
+
+/* -------------------------------------------------
+ * 1) Blocos básicos
+ * ------------------------------------------------- */
+typedef uint32_t BasicBlockId;
+
+const BasicBlockId NO_BASIC_BLOCK = 0xFFFFFFFFu;
+
+enum TerminatorKind {
+    TERM_JUMP,     // segue sempre para `next`
+    TERM_BRANCH,   // condição verdadeira -> `next`, falsa -> `other`
+    TERM_RETURN    // fim de setup()/loop()
+};
+
+/**
+ * @brief Sequência de comandos em linha reta mais o desvio que a encerra.
+ *
+ * Os comandos são um intervalo [begin, end) de um CommandList do AST
+ * (nunca contêm se/enquanto), então o bloco não copia nada.
+ */
+struct BasicBlock {
+    const Command* begin;
+    const Command* end;
+
+    TerminatorKind term;
+    const Expr* condition;   // TERM_BRANCH
+    BasicBlockId next;       // TERM_JUMP: destino; TERM_BRANCH: verdadeiro
+    BasicBlockId other;      // TERM_BRANCH: falso
+
+    // TERM_BRANCH: comando de origem (CMD_IF ou CMD_WHILE) e o bloco onde
+    // os caminhos voltam a se encontrar (fim do se / saída do enquanto).
+    // Permite à geração de código reconstruir if/while sem gotos.
+    const Command* origin;
+    BasicBlockId join;
+
+    size_t size() const { return (size_t)(end - begin); }
+};
+
+/* -------------------------------------------------
+ * 2) Grafo de um bloco de nível superior
+ * ------------------------------------------------- */
+/**
+ * @brief CFG de config (setup) ou repita (loop).
+ *
+ * Os blocos são numerados na ordem do fonte: um percurso por índice
+ * visita os comandos na mesma ordem em que foram escritos. `entry` é
+ * sempre 0 e `exit` é um bloco vazio com TERM_RETURN.
+ */
+struct ControlFlowGraph {
+    ArenaVector<BasicBlock> blocks;
+    BasicBlockId entry;
+    BasicBlockId exit;
+
+    explicit ControlFlowGraph(Arena& arena)
+        : blocks(ArenaAllocator<BasicBlock>(&arena)),
+          entry(NO_BASIC_BLOCK), exit(NO_BASIC_BLOCK) {}
+
+    /**
+     * @brief Esvazia o grafo e solta o vetor de blocos (ver
+     *        ASTProgram::clearBlocks).
+     */
+    void clear() {
+        blocks = ArenaVector<BasicBlock>(blocks.get_allocator());
+        entry = exit = NO_BASIC_BLOCK;
+    }
+};
+
+/**
+ * @brief Os dois grafos do programa. Ficam na arena do ASTProgram e
+ *        apontam para os comandos dele (vivem enquanto ele viver).
+ */
+struct ProgramCfg {
+    ControlFlowGraph setup;   // bloco config
+    ControlFlowGraph loop;    // bloco repita
+
+    explicit ProgramCfg(Arena& arena) : setup(arena), loop(arena) {}
+};
+
+/**
+ * @brief Rebaixa config/repita (com os sub-blocos de se/senão/enquanto)
+ *        para blocos básicos.
+ */
+void buildProgramCfg(const ASTProgram& program, ProgramCfg& cfg);
+
+/**
+ * @brief Rebaixa só uma lista de nível superior (config ou repita), para
+ *        quem tem um bloco completo antes do outro (streaming).
+ */
+void buildCfg(const ASTProgram& program, const CommandList& list, ControlFlowGraph& graph);
+
+/**
+ * @brief Rebaixa os comandos [begin, end) como se fossem uma lista de
+ *        nível superior (ex.: um único comando, na geração em streaming).
+ */
+void buildCfg(const ASTProgram& program, const Command* begin, const Command* end,
+              ControlFlowGraph& graph);
+
+/**
+ * @brief Escreve o grafo em texto (um bloco por linha, com os comandos
+ *        e as arestas), para depuração.
+ */
+void printCfg(std::ostream& out, const ControlFlowGraph& graph, const ASTProgram& program);
+
+#endif // CFG_H
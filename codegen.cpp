@@ -1,16 +1,22 @@
 #include "codegen.h"
-#include <map>
-#include <tuple>
-#include <fstream>
-#include <iostream>
+#include "constprop.h"
+#include "ledc.h"
+#include "liveness.h"
+#include "pinflow.h"
+#include "trace.h"
+#include <ostream>
+#include <utility>
+#include <vector>
 
 /**
- * @brief Auxiliar: converte VarType para string C++ (int, String, bool)
+ * @brief Auxiliar: converte VarType para string C++ (int, String, bool);
+ *        um inteiro usa o tipo escolhido pela análise de faixas
+ *        (uint8_t, uint16_t, ...)
  */
-static std::string varTypeToCpp(VarType t) {
+static std::string varTypeToCpp(VarType t, IntWidth width) {
     switch(t) {
         case VAR_INTEIRO:
-            return "int";
+            return intWidthType(width);
         case VAR_TEXTO:
             return "String";
         case VAR_BOOLEANO:
@@ -21,217 +27,525 @@ static std::string varTypeToCpp(VarType t) {
     }
 }
 
-// Precisamos de um contador de canais e uma estrutura para
-// armazenar (canal,freq,resol)
-static std::map<std::string, std::tuple<int,int,int>> pwmData;
-static int nextChannel = 0;
+/**
+ * @brief Estado de uma geração de código (um por chamada de
+ *        generateCode, sem variáveis estáticas).
+ */
+struct CodegenContext {
+    // Recuo da linha atual (dois espaços por nível de se/enquanto)
+    std::string indent;
+
+    // Estado dos pinos no ponto gerado (chamadas que não mudam nada são
+    // omitidas); desligado, tudo é gerado como está no fonte
+    bool pinFlow;
+    PinFlow flow;
+    size_t omitted;
+
+    // Atribuições de repita que ninguém lê (liveness.h); NULL gera todas
+    const DeadStores* dead;
+    size_t removed;
+
+    // Esperar sem bloquear (só em loop()): cada esperar vira um ponto de
+    // retorno do switch de loop(), numerado a partir de 1
+    bool nonBlockingWait;
+    uint32_t waits;
+    std::string waitVar;  // struct com o estado das esperas
+
+    CodegenContext(bool pf, const ASTProgram& program)
+        : indent("  "), pinFlow(pf), flow(constantPinClasses(program)), omitted(0), dead(NULL), removed(0), nonBlockingWait(false),
+          waits(0) {}
+};
 
 // Prototipos
-static void generateGlobals(std::ofstream &out, ASTProgram &program);
-static void generateSetup(std::ofstream &out, ASTProgram &program);
-static void generateLoop(std::ofstream &out, ASTProgram &program);
+static void generateHeader(std::ostream &out, const ASTProgram &program);
+static void generateGlobals(std::ostream &out, const ASTProgram &program);
+static void generateRegion(CodegenContext &cg, std::ostream &out, const ControlFlowGraph &graph,
+                           BasicBlockId from, BasicBlockId stop, const ASTProgram &program);
+static std::string waitStateName(const ASTProgram &program);
+static void openWaitSwitch(const CodegenContext &cg, std::ostream &out);
+static void closeWaitSwitch(const CodegenContext &cg, std::ostream &out);
 
 /**
  * @brief Função auxiliar que gera a tradução de cada comando
  */
-static void generateCommand(std::ofstream &out, const Command &cmd);
+static void generateCommand(CodegenContext &cg, std::ostream &out, const Command &cmd,
+                            const ASTProgram &program);
 
 /**
  * @brief Função principal de geração de código
  */
-void generateCode(ASTProgram& program, const std::string& outputFilename) {
-    std::ofstream out(outputFilename);
-    if(!out.is_open()) {
-        std::cerr << "Erro ao criar arquivo " << outputFilename << "\n";
-        return;
-    }
+void generateCode(const ASTProgram& program, const ProgramCfg& cfg, std::ostream& out, bool pinFlow,
+                  bool deadStores, bool nonBlockingWait) {
+    generateSetup(program, cfg.setup, out, pinFlow);
+    generateLoop(program, cfg.setup, cfg.loop, out, pinFlow, deadStores, nonBlockingWait);
+}
 
-    // 1) Includes
-    out << "#include <Arduino.h>\n";
-    out << "#include <WiFi.h>\n"; 
+void generateSetup(const ASTProgram& program, const ControlFlowGraph& setup, std::ostream& out,
+                   bool pinFlow) {
+    CodegenContext cg(pinFlow, program);
 
-    // 2) Gera variaveis globais
-    generateGlobals(out, program);
+    // 1) e 2) Includes e variaveis globais
+    generateHeader(out, program);
 
     // 3) Gera setup()
     out << "\nvoid setup() {\n";
-    generateSetup(out, program);
+    generateRegion(cg, out, setup, setup.entry, NO_BASIC_BLOCK, program);
     out << "}\n";
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "setup(): %zu blocos basicos, %zu chamadas de pino omitidas",
+          setup.blocks.size(), cg.omitted);
+}
+
+void generateLoop(const ASTProgram& program, const ControlFlowGraph& setup,
+                  const ControlFlowGraph& loop, std::ostream& out, bool pinFlow, bool deadStores,
+                  bool nonBlockingWait) {
+    CodegenContext cg(pinFlow, program);
+    DeadStores dead;
+    if (deadStores) {
+        dead.run(loop);
+        cg.dead = &dead;
+    }
+    if (cg.pinFlow) {
+        // loop() começa com o estado do fim de setup() ou do fim da volta
+        // anterior (aresta de volta de repita)
+        cg.flow.run(setup);
+        cg.flow.enterLoop(loop, 0, (BasicBlockId)loop.blocks.size());
+    }
 
     // 4) Gera loop()
     out << "\nvoid loop() {\n";
-    generateLoop(out, program);
+    if (nonBlockingWait) {
+        // O switch das esperas só é escrito depois de contá-las no corpo
+        cg.nonBlockingWait = true;
+        cg.waitVar = waitStateName(program);
+        std::ostringstream body;
+        generateRegion(cg, body, loop, loop.entry, NO_BASIC_BLOCK, program);
+        openWaitSwitch(cg, out);
+        out << body.str();
+        closeWaitSwitch(cg, out);
+    } else {
+        generateRegion(cg, out, loop, loop.entry, NO_BASIC_BLOCK, program);
+    }
     out << "}\n";
+    TRACE(TRACE_CODEGEN, TRACE_INFO,
+          "loop(): %zu blocos basicos, %zu chamadas de pino e %zu atribuicoes mortas omitidas, "
+          "%u esperas sem bloquear",
+          loop.blocks.size(), cg.omitted, cg.removed, (unsigned)cg.waits);
+}
 
-    out.close();
-    std::cout << "Código C++ gerado em " << outputFilename << std::endl;
+/**
+ * @brief Nome da struct das esperas de loop(): "esperaLoop", com "_" no
+ *        fim enquanto for o nome de uma variável do programa.
+ */
+static std::string waitStateName(const ASTProgram &program) {
+    std::string name = "esperaLoop";
+    while (program.symbols.declared(program.names.lookup(name))) {
+        name += "_";
+    }
+    return name;
 }
 
-static void generateGlobals(std::ofstream &out, ASTProgram &program) {
-    // Limpa estruturas
-    pwmData.clear();
-    nextChannel = 0;
+/**
+ * @brief Começo de loop() com esperas sem bloquear: o estado fica numa
+ *        struct estática e o switch pula para o "case" da espera em
+ *        andamento (os case ficam dentro dos if/while, que não declaram
+ *        variáveis). Sem esperas, nada é escrito.
+ */
+static void openWaitSwitch(const CodegenContext &cg, std::ostream &out) {
+    if (cg.waits == 0) return;
+    out << "  static struct {\n";
+    out << "    " << intWidthType(intWidthFor(0, (int32_t)cg.waits))
+        << " estado;  // espera em andamento (0 = nenhuma)\n";
+    out << "    unsigned long inicio;\n";
+    out << "    unsigned long tempo;\n";
+    out << "  } " << cg.waitVar << ";\n";
+    out << "  switch (" << cg.waitVar << ".estado) {\n";
+    out << "  case 0:\n";
+}
 
-    // 1) Primeiro, varrer configCommands para encontrar CMD_CONFIG_PWM
-    for (auto &cmd : program.configCommands) {
-        if (cmd.cmdType == CMD_CONFIG_PWM) {
-            auto it = pwmData.find(cmd.pin);
-            if (it == pwmData.end()) {
-                pwmData[cmd.pin] = std::make_tuple(nextChannel, cmd.freq, cmd.resol);
-                nextChannel++;
-            }
-            // Se quiser permitir reconfig do pino, atualize...
-        }
-    }
+/**
+ * @brief Fim do switch: a volta terminou, a próxima começa do início.
+ */
+static void closeWaitSwitch(const CodegenContext &cg, std::ostream &out) {
+    if (cg.waits == 0) return;
+    out << "  }\n";
+    out << "  " << cg.waitVar << ".estado = 0;\n";
+}
+
+/**
+ * @brief Includes e globais (variáveis e as const dos canais PWM).
+ */
+static void generateHeader(std::ostream &out, const ASTProgram &program) {
+    out << "#include <Arduino.h>\n";
+    out << "#include <WiFi.h>\n"; 
+
+    generateGlobals(out, program);
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "Globais: %zu variaveis, %zu canais PWM",
+          program.declarations.size(), program.symbols.pwmCount());
+}
 
-    // 2) Agora imprime as variáveis do AST
+static void generateGlobals(std::ostream &out, const ASTProgram &program) {
+    // 1) Imprime as variáveis do AST
     out << "\n// ========== Variáveis Globais ==========\n";
     for (auto &decl : program.declarations) {
-        std::string cppType = varTypeToCpp(decl.type);
-        out << cppType << " " << decl.name << ";\n";
+        std::string cppType = varTypeToCpp(decl.type, program.symbols.intWidth(decl.name));
+        if (program.symbols.isConstant(decl.name)) {
+            // Nunca muda (constprop.h): a atribuição de config vira o valor
+            out << "constexpr " << cppType << " " << program.names.name(decl.name) << " = "
+                << program.symbols.constValue(decl.name) << ";\n";
+            continue;
+        }
+        out << cppType << " " << program.names.name(decl.name) << ";\n";
+    }
+
+    // 2) Imprime as const do PWM (canais da tabela de símbolos, na ordem
+    //    dos nomes) com o temporizador LEDC de cada canal
+    const SymbolTable &symbols = program.symbols;
+    for (SymbolId id = 0; id < symbols.size(); id++) {
+        if (!symbols.hasPwm(id)) continue;
+        auto pinName = program.names.name(id);
+        int channel = symbols.pwmChannel(id);
+        out << "\nconst int canal_" << pinName << " = " << channel << ";  // temporizador "
+            << ledcTimer(channel);
+        out << "\nconst int freq_" << pinName  << "  = " << symbols.pwmFreq(id) << ";";
+        out << "\nconst int resol_" << pinName << " = " << symbols.pwmResol(id) << ";\n";
     }
 
-    // 3) Imprime as const do PWM
-    for (auto &kv : pwmData) {
-        auto &pinName = kv.first;
-        auto [ch, fr, rs] = kv.second;
-        out << "\nconst int canal_" << pinName << " = " << ch << ";";
-        out << "\nconst int freq_" << pinName  << "  = " << fr << ";";
-        out << "\nconst int resol_" << pinName << " = " << rs << ";\n";
+    // 3) Limite do valor de ajustarPWM sem prova de faixa (ranges.h): sem
+    //    desvios, v < 0 vira 0 e v > max vira max
+    if (symbols.dutyClampCount() != 0) {
+        out << "\nstatic inline int limitarDuty(int v, int max) {\n";
+        out << "  v &= ~(v >> 31);\n";
+        out << "  return v - ((v - max) & ((max - v) >> 31));\n";
+        out << "}\n";
     }
     out << "\n";
 }
 
-static void generateSetup(std::ofstream &out, ASTProgram &program) {
-    // Percorrer configCommands
-    for (auto &cmd : program.configCommands) {
-        generateCommand(out, cmd);
+/* ------------------------------------------------------------------
+   Geração em streaming
+   ------------------------------------------------------------------ */
+CodeSection::~CodeSection() {
+    if (spill) fclose(spill);
+}
+
+void CodeSection::append(const std::string &text) {
+    buffer += text;
+    if (buffer.size() < SPILL_BYTES || failed) return;
+
+    if (!spill) spill = tmpfile();
+    if (!spill) {
+        // Sem arquivo temporário: o trecho continua todo em memória
+        failed = true;
+        return;
+    }
+    if (fwrite(buffer.data(), 1, buffer.size(), spill) != buffer.size()) {
+        failed = true;
+        return;
     }
+    buffer.clear();
+}
 
-    // Depois de processar, declarar as const para PWM:
-    // Precisamos imprimir: 
-    // const int canal_pinX = ...
-    // const int freq_pinX  = ...
-    // const int resol_pinX = ...
-    // ou inverso, se quiser em outro local.
+void CodeSection::writeTo(std::ostream &out) {
+    if (spill) {
+        if (failed) {
+            // Uma escrita no arquivo temporário falhou no meio: parte do
+            // texto se perdeu
+            out.setstate(std::ios::badbit);
+            return;
+        }
+        std::vector<char> chunk(64 * 1024);
+        fflush(spill);
+        fseek(spill, 0, SEEK_SET);
+        size_t n;
+        while ((n = fread(chunk.data(), 1, chunk.size(), spill)) > 0) {
+            out.write(chunk.data(), (std::streamsize)n);
+        }
+        if (ferror(spill)) {
+            out.setstate(std::ios::badbit);
+            return;
+        }
+    }
+    out << buffer;
+}
+
+StreamingCodegen::StreamingCodegen(const ASTProgram &p, bool pinFlow, bool nonBlockingWait)
+    : program(p), cg(new CodegenContext(pinFlow, p)), nonBlockingWait(nonBlockingWait),
+      inLoop(false) {}
+
+StreamingCodegen::~StreamingCodegen() {}
+
+void StreamingCodegen::setupStatement(const ControlFlowGraph &graph) {
+    emit(setup, graph);
+}
+
+void StreamingCodegen::loopStatement(const ControlFlowGraph &graph) {
+    if (!inLoop) {
+        // O fim de repita (aresta de volta) ainda não chegou: na entrada
+        // de loop() nada se sabe sobre os pinos
+        cg->flow.forget();
+        inLoop = true;
+        // As declarações já passaram: o nome da struct das esperas é livre
+        cg->nonBlockingWait = nonBlockingWait;
+        cg->waitVar = waitStateName(program);
+    }
+    emit(loop, graph);
+}
+
+void StreamingCodegen::emit(CodeSection &section, const ControlFlowGraph &graph) {
+    text.str(std::string());
+    generateRegion(*cg, text, graph, graph.entry, NO_BASIC_BLOCK, program);
+    section.append(text.str());
+}
+
+void StreamingCodegen::write(std::ostream &out) {
+    generateHeader(out, program);
+
+    out << "\nvoid setup() {\n";
+    setup.writeTo(out);
+    out << "}\n";
+
+    out << "\nvoid loop() {\n";
+    openWaitSwitch(*cg, out);
+    loop.writeTo(out);
+    closeWaitSwitch(*cg, out);
+    out << "}\n";
+}
+
+/**
+ * @brief Escreve a condição de um if/while. Expressões binárias e
+ *        parênteses já saem entre parênteses ("(brilho>128)").
+ */
+static void generateCondition(std::ostream &out, const Expr *cond, const ASTProgram &program) {
+    bool wrapped = cond->kind == EXPR_BINARIA || cond->kind == EXPR_PARENTESES;
+    if (!wrapped) out << "(";
+    printExpr(out, cond, program);
+    if (!wrapped) out << ")";
 }
 
-static void generateLoop(std::ofstream &out, ASTProgram &program) {
-    for (auto &cmd : program.repitaCommands) {
-        generateCommand(out, cmd);
+/**
+ * @brief Gera os blocos básicos de `from` até chegar em `stop` (ou no
+ *        retorno). Cada desvio do CFG veio de um se/enquanto, então é
+ *        reconstruído como if/else ou while usando BasicBlock::join.
+ */
+static void generateRegion(CodegenContext &cg, std::ostream &out, const ControlFlowGraph &graph,
+                           BasicBlockId from, BasicBlockId stop, const ASTProgram &program) {
+    BasicBlockId id = from;
+    while (id != stop) {
+        const BasicBlock &block = graph.blocks[id];
+        for (const Command *cmd = block.begin; cmd != block.end; ++cmd) {
+            if (cg.dead && cg.dead->dead(id, (size_t)(cmd - block.begin))) {
+                cg.removed++;  // o valor nunca é lido
+                continue;
+            }
+            if (cg.pinFlow) {
+                if (cg.flow.redundant(*cmd)) {
+                    cg.omitted++;  // o pino já está nesse estado
+                    continue;
+                }
+                cg.flow.apply(*cmd);
+            }
+            generateCommand(cg, out, *cmd, program);
+        }
+
+        if (block.term == TERM_RETURN) {
+            return;
+        }
+        if (block.term == TERM_JUMP) {
+            id = block.next;
+            continue;
+        }
+
+        bool isWhile = block.origin->cmdType == CMD_WHILE;
+        int value;
+        if (constantOf(program.symbols, block.condition, value) && (!isWhile || !value)) {
+            // Condição fixa (constprop.h): do se só sai o ramo que roda, e
+            // um enquanto que nunca roda some
+            if (!isWhile) {
+                BasicBlockId taken = value ? block.next : block.other;
+                generateRegion(cg, out, graph, taken, block.join, program);
+            }
+            id = block.join;
+            continue;
+        }
+
+        cg.indent += "  ";
+        // Estado dos pinos: o do cabeçalho vale na saída do while; o if
+        // junta os dois ramos
+        if (cg.pinFlow && isWhile) cg.flow.enterLoop(graph, block.next, block.join);
+        PinStates other = cg.pinFlow ? cg.flow.state : PinStates();
+
+        // Corpo do while termina voltando ao cabeçalho; o do if, no join.
+        // Os ramos são gerados à parte: um ramo de if que ficou vazio
+        // (atribuições mortas, chamadas de pino omitidas) não é escrito
+        std::ostringstream thenBody, elseBody;
+        generateRegion(cg, thenBody, graph, block.next, isWhile ? id : block.join, program);
+        if (!isWhile && block.other != block.join) {
+            if (cg.pinFlow) std::swap(cg.flow.state, other);
+            generateRegion(cg, elseBody, graph, block.other, block.join, program);
+        }
+        cg.indent.resize(cg.indent.size() - 2);
+        if (cg.pinFlow) {
+            if (isWhile) std::swap(cg.flow.state, other);
+            else cg.flow.state.join(other);
+        }
+
+        std::string thenText = thenBody.str(), elseText = elseBody.str();
+        if (isWhile || !thenText.empty()) {
+            out << cg.indent << (isWhile ? "while " : "if ");
+            generateCondition(out, block.condition, program);
+            out << " {\n" << thenText;
+            if (!elseText.empty()) out << cg.indent << "} else {\n" << elseText;
+            out << cg.indent << "}\n";
+        } else if (!elseText.empty()) {
+            // Só o senão faz algo
+            out << cg.indent << "if (!";
+            generateCondition(out, block.condition, program);
+            out << ") {\n" << elseText << cg.indent << "}\n";
+        }
+
+        id = block.join;
     }
 }
 
 /**
  * @brief Gera a linha de código C++ correspondente a um Command específico.
  */
-static void generateCommand(std::ofstream &out, const Command &cmd) {
+static void generateCommand(CodegenContext &cg, std::ostream &out, const Command &cmd,
+                            const ASTProgram &program) {
+    const StringInterner &names = program.names;
+    const std::string &ind = cg.indent;
     switch(cmd.cmdType) {
         case CMD_ASSIGN: {
             // Exemplo:  ledPin = 2;
-            // Se cmd.varName="ledPin" e cmd.expr="2"
-            out << "  " << cmd.varName << " = " << cmd.expr << ";\n";
+            // Se cmd.assign.var="ledPin" e cmd.assign.value=2
+            if (program.symbols.isConstant(cmd.assign.var)) {
+                break;  // já é o inicializador do constexpr
+            }
+            out << ind << names.name(cmd.assign.var) << " = ";
+            printExpr(out, cmd.assign.value, program);
+            out << ";\n";
         } break;
 
         case CMD_CONFIG_PIN: {
             // Exemplo: config pino:   pinMode(ledPin, OUTPUT);
-            // Se cmd.pinMode="saida", use "OUTPUT"
-            // Se cmd.pinMode="entrada", use "INPUT"
-            std::string mode = "OUTPUT";
-            if (cmd.pinMode == "entrada") {
-                mode = "INPUT";
-            }
-            out << "  pinMode(" << cmd.pin << ", " << mode << ");\n";
+            // PINO_SAIDA -> "OUTPUT", PINO_ENTRADA -> "INPUT"
+            const char *mode = cmd.configPin.mode == PINO_ENTRADA ? "INPUT" : "OUTPUT";
+            out << ind << "pinMode(" << names.name(cmd.configPin.pin) << ", " << mode << ");\n";
         } break;
 
         case CMD_CONFIG_PWM: {
-            // canal/freq/resol já está em pwmData, não precisamos atribuir de novo
+            // canal/freq/resol já estão na tabela de símbolos (const globais)
             // Basta imprimir as chamadas usando as const
-            out << "  ledcSetup(canal_" << cmd.pin << ", freq_" 
-            << cmd.pin << ", resol_" << cmd.pin << ");\n";
-            out << "  ledcAttachPin(" << cmd.pin << ", canal_" << cmd.pin << ");\n";
+            std::string_view pin = names.name(cmd.configPwm.pin);
+            out << ind << "ledcSetup(canal_" << pin << ", freq_" 
+            << pin << ", resol_" << pin << ");\n";
+            out << ind << "ledcAttachPin(" << pin << ", canal_" << pin << ");\n";
         } break;
 
         case CMD_PWM_ADJUST: {
-            auto it = pwmData.find(cmd.pin);
-            if (it == pwmData.end()) {
-                // caso o parser permitir configPWM tardio, ou gera erro...
-                // Mas provavelmente no semântico já geraria erro.
+            // O canal existe: sem configurarPWM antes, o semântico já acusou
+            out << ind << "ledcWrite(" 
+                << "canal_" << names.name(cmd.pwmAdjust.pin) << ", ";
+            if (cmd.pwmAdjust.duty == DUTY_CLAMP) {
+                // Pode sair de 0..2^resol-1 (ranges.h)
+                out << "limitarDuty(";
+                printExpr(out, cmd.pwmAdjust.value, program);
+                out << ", " << program.symbols.pwmMaxDuty(cmd.pwmAdjust.pin) << ")";
+            } else {
+                printExpr(out, cmd.pwmAdjust.value, program);
             }
-            out << "  ledcWrite(" 
-                << "canal_" << cmd.pin << ", " << cmd.valueExpr << ");\n";
+            out << ");\n";
         } break;
 
         case CMD_LIGAR: {
             // Exemplo: "ligar ledPin;" => "digitalWrite(ledPin, HIGH);"
-            out << "  digitalWrite(" << cmd.digitalPin << ", HIGH);\n";
+            out << ind << "digitalWrite(" << names.name(cmd.digital.pin) << ", HIGH);\n";
         } break;
 
         case CMD_DESLIGAR: {
             // Exemplo: "desligar ledPin;" => "digitalWrite(ledPin, LOW);"
-            out << "  digitalWrite(" << cmd.digitalPin << ", LOW);\n";
+            out << ind << "digitalWrite(" << names.name(cmd.digital.pin) << ", LOW);\n";
         } break;
 
         case CMD_LER_DIGITAL: {
             // Exemplo: "estadoBotao = digitalRead(botao);"
-            out << "  " << cmd.varName << " = digitalRead(" << cmd.pin << ");\n";
+            out << ind << names.name(cmd.readPin.var) << " = digitalRead(" << names.name(cmd.readPin.pin) << ");\n";
         } break;
         
         case CMD_LER_ANALOGICO: {
             // Exemplo: "sensorValor = analogRead(sensor);"
-            out << "  " << cmd.varName << " = analogRead(" << cmd.pin << ");\n";
+            out << ind << names.name(cmd.readPin.var) << " = analogRead(" << names.name(cmd.readPin.pin) << ");\n";
         } break;
 
         case CMD_WIFI_CONNECT: {
             // Exemplo: "conectarWifi ssid senha;"
             // => 
             // WiFi.begin(ssid.c_str(), password.c_str());
-            out << "  WiFi.begin(" << cmd.ssid << ".c_str(), " 
-                << cmd.password << ".c_str());\n";
-            out << "  while(WiFi.status() != WL_CONNECTED) {\n";
-            out << "    delay(500);\n";
-            out << "  }\n";
+            out << ind << "WiFi.begin(" << names.name(cmd.wifi.ssid) << ".c_str(), " 
+                << names.name(cmd.wifi.password) << ".c_str());\n";
+            if (cg.nonBlockingWait) {
+                // Sai de loop() até conectar (ver CMD_WAIT)
+                uint32_t state = ++cg.waits;
+                out << ind << cg.waitVar << ".estado = " << state << ";\n";
+                out << ind << "return;\n";
+                out << ind << "case " << state << ":\n";
+                out << ind << "if (WiFi.status() != WL_CONNECTED) return;\n";
+                break;
+            }
+            out << ind << "while(WiFi.status() != WL_CONNECTED) {\n";
+            out << ind << "  delay(500);\n";
+            out << ind << "}\n";
         } break;
 
         case CMD_WAIT: {
+            if (cg.nonBlockingWait) {
+                // Marca o início e sai de loop(); as próximas chamadas
+                // pulam para o case e saem de novo até o tempo passar
+                uint32_t state = ++cg.waits;
+                const std::string &w = cg.waitVar;
+                out << ind << w << ".inicio = millis();\n";
+                out << ind << w << ".tempo = ";
+                printExpr(out, cmd.wait.time, program);
+                out << ";\n";
+                out << ind << w << ".estado = " << state << ";\n";
+                out << ind << "return;\n";
+                out << ind << "case " << state << ":\n";
+                out << ind << "if (millis() - " << w << ".inicio < " << w << ".tempo) return;\n";
+                break;
+            }
             // Exemplo: "esperar 1000;" => "delay(1000);"
-            out << "  delay(" << cmd.waitTime << ");\n";
+            out << ind << "delay(";
+            printExpr(out, cmd.wait.time, program);
+            out << ");\n";
         } break;
 
         case CMD_ENVIAR_HTTP: {
             // Exemplo: "enviarHttp \"http://exemplo.com\" \"dados=123\";"
             // => uso de bibliotecas HTTP no ESP32
             // Exemplo rudimentar:
-            out << "  {\n";
-            out << "    HTTPClient http;\n";
-            out << "    http.begin(" << cmd.httpUrl << ");\n";
-            out << "    http.addHeader(\"Content-Type\", "
+            out << ind << "{\n";
+            out << ind << "  HTTPClient http;\n";
+            out << ind << "  http.begin(" << program.literals.name(cmd.http.url) << ");\n";
+            out << ind << "  http.addHeader(\"Content-Type\", "
                 << "\"application/x-www-form-urlencoded\");\n";
-            out << "    int httpCode = http.POST(" << cmd.httpData << ");\n";
-            out << "    http.end();\n";
-            out << "  }\n";
+            out << ind << "  int httpCode = http.POST(" << program.literals.name(cmd.http.data) << ");\n";
+            out << ind << "  http.end();\n";
+            out << ind << "}\n";
         } break;
 
         case CMD_ESCREVER_SERIAL: {
             // Exemplo: "escreverSerial \"Mensagem\";" => "Serial.println(\"Mensagem\");"
-            out << "  Serial.println(" << cmd.serialMsg << ");\n";
+            out << ind << "Serial.println(" << program.literals.name(cmd.serial.msg) << ");\n";
         } break;
 
         case CMD_LER_SERIAL: {
             // Exemplo: "lerSerial;" => "String valor = Serial.readString();"
-            out << "  {\n";
-            out << "    String valor = Serial.readString();\n";
-            out << "    // se quiser fazer algo com 'valor'\n";
-            out << "  }\n";
+            out << ind << "{\n";
+            out << ind << "  String valor = Serial.readString();\n";
+            out << ind << "  // se quiser fazer algo com 'valor'\n";
+            out << ind << "}\n";
         } break;
 
-        case CMD_IF:
-        case CMD_WHILE:
-            // Se sua AST não guarda sub-blocos, pode ser que
-            // você não gere nada específico, ou print um comentário.
-            out << "  // (IF/WHILE) Comandos não expandidos\n";
-            break;
-
         default:
             // se não houver nada definido, ignore.
             break;
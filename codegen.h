@@ -1,14 +1,133 @@
 #ifndef CODEGEN_H
 #define CODEGEN_H
 
+#include <stdio.h>
+#include <memory>
+#include <sstream>
 #include <string>
 #include "ast.h"
+#include "cfg.h"
 
 /**
- * @brief Gera um arquivo C++ (Arduino/ESP32) a partir do ASTProgram.
- * @param program O AST do programa (contém declarações e comandos).
- * @param outputFilename Caminho/nome do arquivo .cpp a ser gerado.
+ * @brief Gera o C++ (Arduino/ESP32) do ASTProgram em `out`.
+ * @param program O AST do programa (contém declarações e comandos), já
+ *        verificado: tipos e canais PWM vêm de program.symbols, que a
+ *        análise semântica preenche.
+ * @param cfg Grafos de config/repita (buildProgramCfg); setup() e
+ *        loop() são gerados a partir deles, com if/else e while. De um
+ *        se com condição constante (constprop.h) só sai o ramo que roda;
+ *        um enquanto constante falso e um se com os dois ramos vazios
+ *        somem.
+ * @param out Destino do código (arquivo, string, ...).
+ * @param pinFlow Omite pinMode, ledcSetup/ledcAttachPin e digitalWrite
+ *        que não mudam o estado do pino (pinflow.h).
+ * @param deadStores Omite as atribuições de repita cujo valor nunca é
+ *        lido (liveness.h).
+ * @param nonBlockingWait Em loop(), `esperar` (e a espera do
+ *        conectarWifi) não chama delay(): loop() guarda onde parou,
+ *        retorna e, nas chamadas seguintes, continua dali quando millis()
+ *        passar do tempo (um switch com um case por espera). setup()
+ *        continua com delay().
  */
-void generateCode(ASTProgram& program, const std::string& outputFilename);
+void generateCode(const ASTProgram& program, const ProgramCfg& cfg, std::ostream& out,
+                  bool pinFlow = true, bool deadStores = true, bool nonBlockingWait = false);
+
+/**
+ * @brief Primeira metade de generateCode: includes, globais e setup().
+ */
+void generateSetup(const ASTProgram& program, const ControlFlowGraph& setup, std::ostream& out,
+                   bool pinFlow = true);
+
+/**
+ * @brief Segunda metade de generateCode: loop(). Usa o grafo de config
+ *        para o estado dos pinos na entrada.
+ */
+void generateLoop(const ASTProgram& program, const ControlFlowGraph& setup,
+                  const ControlFlowGraph& loop, std::ostream& out, bool pinFlow = true,
+                  bool deadStores = true, bool nonBlockingWait = false);
+
+/**
+ * @brief Trecho de código gerado aos poucos (corpo de setup() ou de
+ *        loop()). Fica em memória até SPILL_BYTES e daí em diante vai
+ *        para um arquivo temporário, então um corpo enorme não ocupa
+ *        memória.
+ */
+class CodeSection {
+public:
+    static const size_t SPILL_BYTES = 1024 * 1024;
+
+    CodeSection() : spill(NULL), failed(false) {}
+    ~CodeSection();
+
+    void append(const std::string& text);
+
+    /**
+     * @brief Copia o trecho inteiro para `out`, na ordem. Uma falha no
+     *        arquivo temporário marca `out` com badbit.
+     */
+    void writeTo(std::ostream& out);
+
+private:
+    std::string buffer;  // parte ainda em memória (depois da parte em `spill`)
+    FILE* spill;         // tmpfile(), criado no primeiro transbordo
+    bool failed;
+
+    CodeSection(const CodeSection&) = delete;
+    CodeSection& operator=(const CodeSection&) = delete;
+};
+
+struct CodegenContext;
+
+/**
+ * @brief Geração de código em uma passada, comando a comando: cada
+ *        comando de nível superior é traduzido assim que chega (já
+ *        verificado, como o grafo de um comando só) e vai para a seção
+ *        de setup() ou de loop(). Os canais PWM ficam na tabela de
+ *        símbolos, preenchida pela análise semântica à medida que os
+ *        configurarPWM aparecem. write() costura includes, globais e as
+ *        duas seções.
+ *
+ * A memória fica proporcional às declarações e aos pinos PWM, não ao
+ * programa: o AST de cada comando pode ser descartado depois da
+ * chamada. O texto final é o mesmo de generateCode(), exceto que, sem o
+ * fim de repita, a entrada de loop() não conhece o estado dos pinos
+ * (menos chamadas redundantes são omitidas ali).
+ */
+class StreamingCodegen {
+public:
+    explicit StreamingCodegen(const ASTProgram& program, bool pinFlow = true,
+                              bool nonBlockingWait = false);
+    ~StreamingCodegen();
+
+    /**
+     * @brief Traduz o grafo de um comando de config (buildCfg de
+     *        [cmd, cmd + 1)) para a seção de setup().
+     */
+    void setupStatement(const ControlFlowGraph& graph);
+
+    /**
+     * @brief Traduz o grafo de um comando de repita para a seção de loop().
+     */
+    void loopStatement(const ControlFlowGraph& graph);
+
+    /**
+     * @brief Escreve o programa completo em `out`.
+     */
+    void write(std::ostream& out);
+
+private:
+    const ASTProgram& program;
+    std::unique_ptr<CodegenContext> cg;
+    CodeSection setup;
+    CodeSection loop;
+    bool nonBlockingWait;     // esperar sem bloquear em loop() (generateCode)
+    bool inLoop;              // já chegou o primeiro comando de repita
+    std::ostringstream text;  // código de um comando antes de ir para a seção
+
+    void emit(CodeSection& section, const ControlFlowGraph& graph);
+
+    StreamingCodegen(const StreamingCodegen&) = delete;
+    StreamingCodegen& operator=(const StreamingCodegen&) = delete;
+};
 
 #endif // CODEGEN_H
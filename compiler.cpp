@@ -0,0 +1,196 @@
+#include "compiler.h"
+#include "cfg.h"
+#include "codegen.h"
+#include "constprop.h"
+#include "hoist.h"
+#include "ledc.h"
+#include "semantic.h"
+#include <sstream>
+
+CompileResult Compiler::compile(SourceBuffer& source, const CompileOptions& options) {
+    CompileResult result;
+    result.diagnostics.setLimit(options.maxDiagnostics);
+    result.warnings.setLimit(options.maxDiagnostics);
+
+    // Libera a arena da compilação anterior de uma vez e reusa os blocos
+    astProgram.clear();
+    int parsed = parseProgram(source, astProgram, result.diagnostics, options.frontend);
+
+    result.declarations = astProgram.declarations.size();
+    result.configCommands = astProgram.configCommands.size();
+    result.repitaCommands = astProgram.repitaCommands.size();
+
+    // Com erros léxicos ou de sintaxe (mesmo recuperados) o AST está
+    // incompleto: a semântica só geraria erros em cascata
+    if (parsed != 0 || !result.diagnostics.empty()) {
+        return result;
+    }
+
+    // Blocos básicos de config/repita (na arena do AST)
+    ProgramCfg cfg(astProgram.arena);
+    buildProgramCfg(astProgram, cfg);
+    if (options.dumpCfg) {
+        std::ostringstream text;
+        text << "\n========== CFG de config (" << source.name << ") ==========\n";
+        printCfg(text, cfg.setup, astProgram);
+        text << "========== CFG de repita ==========\n";
+        printCfg(text, cfg.loop, astProgram);
+        result.cfgText = text.str();
+    }
+
+    if (!semanticAnalysis(astProgram, cfg, result.diagnostics)) {
+        return result;
+    }
+    if (options.pwmRanges || options.narrowTypes) {
+        // Faixa dos valores de ajustarPWM ("sempre fora" é erro) e de
+        // cada variável
+        RangeAnalysis ranges(astProgram, result.diagnostics, options.pwmRanges);
+        ranges.start();
+        bool ok = ranges.run(cfg.setup, false);
+        ok = ranges.run(cfg.loop, true) && ok;
+        if (!ok) {
+            return result;
+        }
+        if (options.narrowTypes) {
+            ranges.chooseWidths();
+        }
+    }
+    if (options.constFold) {
+        propagateConstants(astProgram);
+    }
+    if (options.hoist && hoistInvariants(astProgram, result.warnings) != 0) {
+        // Comandos mudaram de repita para config: grafos novos
+        cfg.setup.clear();
+        cfg.loop.clear();
+        buildProgramCfg(astProgram, cfg);
+    }
+
+    std::ostringstream code;
+    generateCode(astProgram, cfg, code, options.pinFlow, options.deadStores,
+                 options.nonBlockingWait);
+    result.code = code.str();
+    result.ramSaved = astProgram.symbols.narrowedBytes();
+    result.pwmChannels = astProgram.symbols.pwmCount();
+    result.pwmTimers = ledcTimerCount(astProgram.symbols);
+    result.ok = true;
+    return result;
+}
+
+CompileResult Compiler::compile(const char* text, size_t length, const CompileOptions& options,
+                                const std::string& name) {
+    SourceBuffer source;
+    if (!source.loadText(text, length, name)) {
+        return CompileResult();
+    }
+    return compile(source, options);
+}
+
+CompileResult compileProgram(const std::string& text, const CompileOptions& options) {
+    Compiler compiler;
+    return compiler.compile(text, options);
+}
+
+/* ------------------------------------------------------------------
+   Compilação em streaming
+   ------------------------------------------------------------------ */
+StreamCompiler::StreamCompiler(const CompileOptions& o, const std::string& n)
+    : options(o), name(n), graph(astProgram.arena), analyzer(astProgram, result.diagnostics),
+      ranges(astProgram, result.diagnostics, o.pwmRanges), codegen(astProgram, o.pinFlow, o.nonBlockingWait),
+      parser(astProgram, result.diagnostics, this), statementStart(astProgram.arena.mark()),
+      inLoop(false), finished(false) {
+    result.diagnostics.setLimit(options.maxDiagnostics);
+}
+
+/**
+ * @brief Sem erro léxico ou de sintaxe até agora: o AST lido é confiável.
+ *        Um diagnóstico descartado pelo limite pode ter sido um deles.
+ *        Custo constante (é perguntado a cada comando).
+ */
+bool StreamCompiler::frontendClean() const {
+    return !parser.frontendError() && result.diagnostics.droppedCount() == 0;
+}
+
+void StreamCompiler::declarationsDone() {
+    if (frontendClean()) {
+        analyzer.declarations();
+        ranges.start();
+    }
+    // As declarações ficam; tudo o que vier depois é de um comando só
+    statementStart = astProgram.arena.mark();
+}
+
+bool StreamCompiler::statement(const Command& cmd, bool loop) {
+    size_t& count = loop ? result.repitaCommands : result.configCommands;
+    count++;
+
+    if (frontendClean()) {
+        buildCfg(astProgram, &cmd, &cmd + 1, graph);
+        bool ok = analyzer.graph(graph);
+        if (ok && (options.pwmRanges || options.narrowTypes)) {
+            if (loop && !inLoop) {
+                // Sem o fim de repita, a entrada de loop() não tem valores
+                ranges.forget();
+                inLoop = true;
+            }
+            ok = ranges.run(graph, false);
+        }
+        // Depois do primeiro erro não há código a gerar, só erros a achar
+        if (ok && result.diagnostics.empty()) {
+            if (options.constFold) {
+                foldConstants(astProgram, &cmd, &cmd + 1);
+            }
+            if (loop) {
+                codegen.loopStatement(graph);
+            } else {
+                codegen.setupStatement(graph);
+            }
+        }
+        graph.clear();
+    }
+
+    // Descarta o comando: sub-blocos, blocos básicos e nós de expressão
+    // (os nomes ficam em textArena)
+    astProgram.clearBlocks();
+    astProgram.arena.rewind(statementStart);
+    return true;
+}
+
+bool StreamCompiler::feed(const char* data, size_t length) {
+    return !finished && parser.feed(data, length);
+}
+
+CompileResult StreamCompiler::finish() {
+    std::ostringstream code;
+    CompileResult r = finish(code);
+    if (r.ok) {
+        r.code = code.str();
+    }
+    return r;
+}
+
+CompileResult StreamCompiler::finish(std::ostream& out) {
+    if (finished) return result;
+    finished = true;
+
+    int parsed = parser.finish();
+    result.declarations = astProgram.declarations.size();
+
+    // Os canais PWM dependem de todos os configurarPWM
+    if (parsed == 0 && frontendClean()) {
+        analyzer.finish();
+    }
+    if (parsed != 0 || !result.diagnostics.empty()) {
+        return result;
+    }
+
+    if (options.narrowTypes) {
+        // Os globais só são escritos agora: todos os comandos já passaram
+        ranges.chooseWidths();
+        result.ramSaved = astProgram.symbols.narrowedBytes();
+    }
+    result.pwmChannels = astProgram.symbols.pwmCount();
+    result.pwmTimers = ledcTimerCount(astProgram.symbols);
+    codegen.write(out);
+    result.ok = true;
+    return result;
+}
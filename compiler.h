@@ -0,0 +1,198 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stddef.h>
+#include <string>
+#include "ast.h"
+#include "cfg.h"
+#include "codegen.h"
+#include "diagnostics.h"
+#include "frontend.h"
+#include "ranges.h"
+#include "semantic.h"
+#include "source.h"
+
+/**
+ * @brief Opções de uma compilação.
+ */
+struct CompileOptions {
+    FrontendOptions frontend;  // léxico, parser e threads do léxico
+    bool dumpCfg;              // preenche CompileResult::cfgText
+    size_t maxDiagnostics;     // diagnósticos guardados (0 = sem limite)
+    bool pinFlow;              // omite chamadas de pino redundantes (pinflow.h)
+    bool constFold;            // dobra e propaga constantes (constprop.h)
+    bool deadStores;           // omite atribuições mortas de repita (liveness.h)
+    bool pwmRanges;            // prova a faixa de ajustarPWM, limita o resto (ranges.h)
+    bool hoist;                // leva comandos invariantes de repita para config (hoist.h)
+    bool narrowTypes;          // menor tipo C++ para cada inteiro (ranges.h)
+    bool nonBlockingWait;      // esperar em repita sem delay(), com millis() (codegen.h)
+
+    CompileOptions()
+        : dumpCfg(false), maxDiagnostics(100), pinFlow(true), constFold(true), deadStores(true),
+          pwmRanges(true), hoist(true), narrowTypes(true), nonBlockingWait(false) {}
+};
+
+/**
+ * @brief Resultado de uma compilação. Nada é impresso: o chamador decide
+ *        o que fazer com o código e com os diagnósticos.
+ */
+struct CompileResult {
+    bool ok;                      // true se `code` foi gerado
+    std::string code;             // C++ (Arduino/ESP32) gerado
+    DiagnosticList diagnostics;   // todos os erros léxicos, de sintaxe e semânticos
+    DiagnosticList warnings;      // avisos (DIAG_AVISO), que não impedem a geração
+
+    // Resumo do AST (mesmo com erro semântico)
+    size_t declarations;
+    size_t configCommands;
+    size_t repitaCommands;
+
+    size_t ramSaved;              // bytes de globais a menos com tipos estreitos (narrowTypes)
+    size_t pwmChannels;           // canais LEDC usados (ledc.h)
+    size_t pwmTimers;             // temporizadores LEDC usados
+
+    std::string cfgText;          // grafos de config/repita (CompileOptions::dumpCfg)
+
+    CompileResult()
+        : ok(false), declarations(0), configCommands(0), repitaCommands(0), ramSaved(0),
+          pwmChannels(0), pwmTimers(0) {}
+};
+
+/**
+ * @brief Compilador embutível: fonte -> léxico -> parser -> CFG ->
+ *        semântica -> código.
+ *
+ * Não usa estado global, não escreve em stdout/stderr e não encerra o
+ * processo. Um Compiler mantém o ASTProgram (e a arena) entre as
+ * chamadas, então compilar vários programas com o mesmo objeto reusa a
+ * memória ("compilador quente"). Um objeto deve ser usado por uma thread
+ * de cada vez; objetos diferentes podem compilar em paralelo.
+ *
+ * O trace (trace.h), se usado, deve ser configurado antes das compilações.
+ */
+class Compiler {
+public:
+    Compiler() {}
+
+    /**
+     * @brief Compila um texto em memória (copiado para um buffer próprio).
+     * @param name Nome usado nas mensagens (ex.: caminho do arquivo).
+     */
+    CompileResult compile(const char* text, size_t length,
+                          const CompileOptions& options = CompileOptions(),
+                          const std::string& name = "<entrada>");
+
+    CompileResult compile(const std::string& text,
+                          const CompileOptions& options = CompileOptions()) {
+        return compile(text.data(), text.size(), options);
+    }
+
+    /**
+     * @brief Compila um fonte já carregado (ex.: arquivo mapeado), sem cópia.
+     */
+    CompileResult compile(SourceBuffer& source, const CompileOptions& options = CompileOptions());
+
+    /**
+     * @brief AST da última compilação (válido até a próxima).
+     */
+    const ASTProgram& program() const { return astProgram; }
+
+private:
+    ASTProgram astProgram;
+
+    Compiler(const Compiler&) = delete;
+    Compiler& operator=(const Compiler&) = delete;
+};
+
+/**
+ * @brief Compilação em streaming: o fonte chega em pedaços (feed) e cada
+ *        comando é processado assim que termina, sem esperar o resto.
+ *
+ * - ao chegar o "config", as declarações passam pela semântica;
+ * - cada comando de nível superior de config/repita (com os seus
+ *   se/senão/enquanto) é verificado e traduzido assim que o parser o
+ *   reconhece, e o seu AST é descartado (StreamingCodegen);
+ * - em finish(), includes, globais, setup() e loop() são costurados.
+ *
+ * Como nenhum comando fica no AST, a memória é proporcional às
+ * declarações (tabela de símbolos, nomes, pinos PWM) e não ao programa;
+ * setup() e loop() grandes vão para arquivos temporários, e
+ * finish(std::ostream&) escreve o código sem montá-lo em memória.
+ *
+ * Usa sempre o parser Bison em modo push com o SimdLexer (StreamParser);
+ * as opções de léxico/parser de CompileOptions::frontend e dumpCfg são
+ * ignoradas. O código e os erros são os mesmos de Compiler::compile(),
+ * exceto que erros semânticos de comandos anteriores a um erro de
+ * sintaxe continuam na lista (já foram relatados), que, com `pinFlow`,
+ * loop() começa sem saber o estado dos pinos (StreamingCodegen), e que,
+ * com `constFold`, só as contas entre literais são dobradas (não há
+ * variáveis constexpr: elas dependem do programa inteiro). `deadStores`
+ * é ignorada: um comando não pode ser omitido antes de se ver o resto
+ * de repita. Com `pwmRanges`, loop() também começa sem saber o valor das
+ * variáveis: lá menos ajustarPWM são provados (mais são limitados, e
+ * menos erros de faixa são acusados); com `narrowTypes`, os
+ * inteiros escritos em repita ficam mais largos pelo mesmo motivo.
+ * `hoist` também é ignorada: para subir um comando de repita é preciso
+ * ver repita inteiro.
+ */
+class StreamCompiler : private ParseListener {
+public:
+    explicit StreamCompiler(const CompileOptions& options = CompileOptions(),
+                            const std::string& name = "<stream>");
+
+    /**
+     * @brief Entrega mais um pedaço do fonte (de qualquer tamanho).
+     * @return false se não adianta mandar mais (análise abandonada).
+     */
+    bool feed(const char* data, size_t length);
+
+    /**
+     * @brief Fim do fonte: termina a análise e devolve o resultado, com
+     *        o código em `code`.
+     */
+    CompileResult finish();
+
+    /**
+     * @brief Como finish(), mas escreve o código direto em `out` (se
+     *        `ok`) e deixa `code` vazio. Um erro de escrita fica no
+     *        estado de `out`.
+     */
+    CompileResult finish(std::ostream& out);
+
+    /**
+     * @brief Diagnósticos encontrados até agora (crescem a cada feed).
+     */
+    const DiagnosticList& diagnostics() const { return result.diagnostics; }
+
+    /**
+     * @brief O AST mantido: só declarações e nomes (os comandos são
+     *        descartados depois de gerados).
+     */
+    const ASTProgram& program() const { return astProgram; }
+
+private:
+    CompileOptions options;
+    std::string name;
+    ASTProgram astProgram;
+    CompileResult result;
+    ControlFlowGraph graph;     // grafo do comando em processamento
+    SemanticAnalyzer analyzer;
+    RangeAnalysis ranges;
+    StreamingCodegen codegen;
+    StreamParser parser;
+    Arena::Mark statementStart; // arena logo depois das declarações
+    bool inLoop;                // já chegou o primeiro comando de repita
+    bool finished;
+
+    bool frontendClean() const;
+    void declarationsDone() override;
+    bool statement(const Command& cmd, bool loop) override;
+};
+
+/**
+ * @brief Compila `text` com um Compiler temporário. Pode ser chamada de
+ *        várias threads ao mesmo tempo.
+ */
+CompileResult compileProgram(const std::string& text, const CompileOptions& options = CompileOptions());
+
+#endif // COMPILER_H
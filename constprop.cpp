@@ -0,0 +1,256 @@
+#include "constprop.h"
+#include "trace.h"
+#include <limits.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief `a op b` com a aritmética de int do ESP32.
+ * @return false se não dá para dobrar (estouro ou divisão por zero).
+ */
+static bool evalBinary(BinaryOp op, int a, int b, int& result) {
+    int64_t x = a, y = b, r;
+    switch (op) {
+        case OP_MAIS:        r = x + y; break;
+        case OP_MENOS:       r = x - y; break;
+        case OP_VEZES:       r = x * y; break;
+        case OP_DIV:
+            if (y == 0) return false;
+            r = x / y;  // trunca em direção a zero, como em C++
+            break;
+        case OP_MENOR:       r = x < y;  break;
+        case OP_MAIOR:       r = x > y;  break;
+        case OP_MENOR_IGUAL: r = x <= y; break;
+        case OP_MAIOR_IGUAL: r = x >= y; break;
+        case OP_IGUAL_IGUAL: r = x == y; break;
+        case OP_DIFERENTE:   r = x != y; break;
+        default:             return false;
+    }
+    // INT_MIN também fica de fora: "-2147483648" não é um literal int em C++
+    if (r <= INT_MIN || r > INT_MAX) return false;
+    result = (int)r;
+    return true;
+}
+
+bool constantOf(const SymbolTable& symbols, const Expr* e, int& value) {
+    if (e->kind == EXPR_NUMERO) {
+        value = e->value;
+        return true;
+    }
+    if (e->kind == EXPR_IDENT && symbols.isConstant(e->symbol)) {
+        value = symbols.constValue(e->symbol);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Dobra as expressões dos comandos (e dos seus sub-blocos).
+ */
+class ConstantFolder {
+public:
+    explicit ConstantFolder(const ASTProgram& p) : folded(0), program(p) {}
+
+    size_t folded;  // subexpressões trocadas por número
+
+    void expr(Expr* root);
+    void command(const Command& cmd);
+    void list(const Command* begin, const Command* end) {
+        for (const Command* c = begin; c != end; ++c) command(*c);
+    }
+    void list(const CommandList& cmds) { list(cmds.data(), cmds.data() + cmds.size()); }
+
+private:
+    const ASTProgram& program;
+    std::vector<Expr*> nodes;  // nós da expressão em dobra (reusado)
+};
+
+void ConstantFolder::expr(Expr* root) {
+    // Em largura, cada nó entra depois do pai: de trás para frente os
+    // operandos são dobrados antes de quem os usa, sem recursão (cadeias
+    // como a+b+c+... são muito profundas)
+    nodes.clear();
+    nodes.push_back(root);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        Expr* e = nodes[i];
+        if (e->left) nodes.push_back(e->left);
+        if (e->right) nodes.push_back(e->right);
+    }
+
+    const SymbolTable& symbols = program.symbols;
+    for (size_t i = nodes.size(); i-- > 0;) {
+        Expr* e = nodes[i];
+        int a, b, value;
+        if (e->kind == EXPR_PARENTESES) {
+            if (!constantOf(symbols, e->left, value)) continue;
+        } else if (e->kind == EXPR_BINARIA) {
+            if (!constantOf(symbols, e->left, a) || !constantOf(symbols, e->right, b)
+                || !evalBinary(e->op, a, b, value)) {
+                continue;
+            }
+        } else {
+            continue;
+        }
+        // O nó vira o número (o tipo verificado continua o mesmo)
+        e->kind = EXPR_NUMERO;
+        e->value = value;
+        e->left = e->right = NULL;
+        folded++;
+    }
+}
+
+void ConstantFolder::command(const Command& cmd) {
+    switch (cmd.cmdType) {
+        case CMD_ASSIGN:
+            expr(cmd.assign.value);
+            break;
+        case CMD_PWM_ADJUST:
+            expr(cmd.pwmAdjust.value);
+            break;
+        case CMD_WAIT:
+            expr(cmd.wait.time);
+            break;
+        case CMD_IF:
+        case CMD_WHILE:
+            expr(cmd.cond.condition);
+            list(program.block(cmd.cond.body));
+            if (cmd.cond.elseBody != NO_BLOCK) list(program.block(cmd.cond.elseBody));
+            break;
+        default:
+            break;
+    }
+}
+
+const uint32_t AFTER_CONFIG = 0xFFFFFFFFu;
+
+/**
+ * @brief Quantas vezes cada variável é escrita e qual o primeiro comando
+ *        de nível superior de config que a lê (AFTER_CONFIG se nenhum).
+ */
+class VariableUse {
+public:
+    VariableUse(const ASTProgram& p, size_t names)
+        : program(p), writes(names, 0), firstRead(names, AFTER_CONFIG) {}
+
+    const ASTProgram& program;
+    std::vector<uint32_t> writes;
+    std::vector<uint32_t> firstRead;
+
+    void command(const Command& cmd, uint32_t index);
+
+private:
+    std::vector<const Expr*> stack;
+
+    void read(SymbolId id, uint32_t index) {
+        if (index < firstRead[id]) firstRead[id] = index;
+    }
+    void readExpr(const Expr* root, uint32_t index);
+    void list(const CommandList& cmds, uint32_t index) {
+        for (const Command& c : cmds) command(c, index);
+    }
+};
+
+void VariableUse::readExpr(const Expr* root, uint32_t index) {
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Expr* e = stack.back();
+        stack.pop_back();
+        if (e->kind == EXPR_IDENT) read(e->symbol, index);
+        if (e->left) stack.push_back(e->left);
+        if (e->right) stack.push_back(e->right);
+    }
+}
+
+void VariableUse::command(const Command& cmd, uint32_t index) {
+    switch (cmd.cmdType) {
+        case CMD_ASSIGN:
+            writes[cmd.assign.var]++;
+            readExpr(cmd.assign.value, index);
+            break;
+        case CMD_LER_DIGITAL:
+        case CMD_LER_ANALOGICO:
+            writes[cmd.readPin.var]++;
+            read(cmd.readPin.pin, index);
+            break;
+        case CMD_CONFIG_PIN:
+            read(cmd.configPin.pin, index);
+            break;
+        case CMD_CONFIG_PWM:
+            read(cmd.configPwm.pin, index);
+            break;
+        case CMD_PWM_ADJUST:
+            read(cmd.pwmAdjust.pin, index);
+            readExpr(cmd.pwmAdjust.value, index);
+            break;
+        case CMD_LIGAR:
+        case CMD_DESLIGAR:
+            read(cmd.digital.pin, index);
+            break;
+        case CMD_WIFI_CONNECT:
+            read(cmd.wifi.ssid, index);
+            read(cmd.wifi.password, index);
+            break;
+        case CMD_WAIT:
+            readExpr(cmd.wait.time, index);
+            break;
+        case CMD_IF:
+        case CMD_WHILE:
+            readExpr(cmd.cond.condition, index);
+            list(program.block(cmd.cond.body), index);
+            if (cmd.cond.elseBody != NO_BLOCK) list(program.block(cmd.cond.elseBody), index);
+            break;
+        default:
+            break;
+    }
+}
+
+size_t propagateConstants(ASTProgram& program) {
+    SymbolTable& symbols = program.symbols;
+    const CommandList& config = program.configCommands;
+
+    VariableUse use(program, program.names.size());
+    for (uint32_t i = 0; i < config.size(); i++) {
+        use.command(config[i], i);
+    }
+    for (const Command& cmd : program.repitaCommands) {
+        use.command(cmd, AFTER_CONFIG);
+    }
+
+    // 1) Nunca escritas: valem 0 (inicialização das globais) do começo ao fim
+    for (const VarDecl& decl : program.declarations) {
+        if (use.writes[decl.name] == 0 && symbols.type(decl.name) != VAR_TEXTO) {
+            symbols.setConstant(decl.name, 0);
+        }
+    }
+
+    // 2) Escritas uma vez, em config, antes de qualquer leitura. Na ordem
+    //    do fonte: o valor só pode usar constantes já decididas
+    ConstantFolder folder(program);
+    for (uint32_t i = 0; i < config.size(); i++) {
+        const Command& cmd = config[i];
+        if (cmd.cmdType != CMD_ASSIGN) continue;
+        SymbolId var = cmd.assign.var;
+        VarType type = symbols.type(var);
+        if (use.writes[var] != 1 || use.firstRead[var] < i || type == VAR_TEXTO) continue;
+
+        folder.expr(cmd.assign.value);
+        int value;
+        if (constantOf(symbols, cmd.assign.value, value)) {
+            symbols.setConstant(var, type == VAR_BOOLEANO ? value != 0 : value);
+        }
+    }
+
+    // 3) Dobra o resto do programa com todas as constantes
+    folder.list(config);
+    folder.list(program.repitaCommands);
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "Constantes: %zu variaveis constexpr, %zu expressoes dobradas",
+          symbols.constantCount(), folder.folded);
+    return folder.folded;
+}
+
+size_t foldConstants(const ASTProgram& program, const Command* begin, const Command* end) {
+    ConstantFolder folder(program);
+    folder.list(begin, end);
+    return folder.folded;
+}
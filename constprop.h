@@ -0,0 +1,41 @@
+#ifndef CONSTPROP_H
+#define CONSTPROP_H
+
+#include <stddef.h>
+#include "ast.h"
+
+/**
+ * @brief Propagação e dobra de constantes, entre a análise semântica e a
+ *        geração de código (o programa já foi verificado).
+ *
+ * - Uma variável inteiro/booleano é constante quando nunca muda: ou nunca
+ *   é escrita (vale 0, como toda global), ou é escrita uma única vez, por
+ *   uma atribuição de nível superior em config cujo valor é constante e
+ *   que vem antes de qualquer leitura dela. Ela vira um `constexpr` com
+ *   esse valor (program.symbols), e a atribuição some de setup().
+ * - Toda subexpressão com operandos constantes (literais ou variáveis
+ *   constantes) é trocada, no próprio AST, por um número. Um nome de
+ *   variável constante sozinho continua como nome (já é constexpr).
+ *
+ * A dobra segue o int de 32 bits do ESP32: uma conta que estouraria, ou
+ * uma divisão por zero, fica como está no fonte.
+ *
+ * @return Número de subexpressões dobradas.
+ */
+size_t propagateConstants(ASTProgram& program);
+
+/**
+ * @brief Só a dobra, nos comandos [begin, end) (e nos seus se/enquanto),
+ *        com as constantes que program.symbols já conhece. Usada pela
+ *        compilação em streaming, que não vê o programa inteiro.
+ */
+size_t foldConstants(const ASTProgram& program, const Command* begin, const Command* end);
+
+/**
+ * @brief Valor de `e` se ele já é constante (número ou variável
+ *        constante). Depois da dobra, uma condição de se/enquanto que só
+ *        depende de constantes é um número.
+ */
+bool constantOf(const SymbolTable& symbols, const Expr* e, int& value);
+
+#endif // CONSTPROP_H
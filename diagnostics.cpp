@@ -0,0 +1,30 @@
+#include "diagnostics.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+void DiagnosticList::report(DiagnosticKind kind, int line, const char* fmt, ...) {
+    if (full()) {
+        dropped++;
+        return;
+    }
+
+    char buffer[512];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+
+    Diagnostic d;
+    d.kind = kind;
+    d.line = line;
+    if (n >= 0 && (size_t)n >= sizeof(buffer)) {
+        // Mensagem longa (ex.: símbolo enorme): formata de novo no tamanho certo
+        d.message.resize((size_t)n);
+        va_start(args, fmt);
+        vsnprintf(&d.message[0], (size_t)n + 1, fmt, args);
+        va_end(args);
+    } else {
+        d.message.assign(buffer, n < 0 ? 0 : (size_t)n);
+    }
+    items.push_back(d);
+}
@@ -0,0 +1,75 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <string>
+#include <vector>
+
+/* -------------------------------------------------
+ * 1) Origem de um diagnóstico
+ * ------------------------------------------------- */
+enum DiagnosticKind {
+    DIAG_LEXICO,      // caractere inválido
+    DIAG_SINTATICO,   // erro de sintaxe (Bison ou descendente recursivo)
+    DIAG_SEMANTICO,   // variável não declarada, tipos, pinos, etc.
+    DIAG_AVISO        // não impede a geração (CompileResult::warnings)
+};
+
+/**
+ * @brief Um erro encontrado durante a compilação.
+ */
+struct Diagnostic {
+    DiagnosticKind kind;
+    int line;             // linha no fonte (0 se desconhecida)
+    std::string message;  // texto completo, como o CLI imprime
+};
+
+/**
+ * @brief Erros de uma compilação, na ordem em que foram encontrados.
+ *        Cada compilação tem a sua lista (nada é global), e nenhuma fase
+ *        imprime nem encerra o processo: quem chama decide o que fazer.
+ *
+ * As fases continuam depois de um erro (o parser se recupera no próximo
+ * ';' e a semântica verifica todos os comandos), então uma execução
+ * acumula todos os erros. Com um limite, os excedentes só são contados.
+ */
+class DiagnosticList {
+public:
+    DiagnosticList() : limit(0), dropped(0) {}
+
+    /**
+     * @brief Formata (como printf) e acrescenta um diagnóstico.
+     */
+    void report(DiagnosticKind kind, int line, const char* fmt, ...)
+        __attribute__((format(printf, 4, 5)));
+
+    /**
+     * @brief Máximo de diagnósticos guardados (0 = sem limite).
+     */
+    void setLimit(size_t max) { limit = max; }
+
+    /**
+     * @brief true quando o limite foi atingido: as fases podem parar cedo.
+     */
+    bool full() const { return limit != 0 && items.size() >= limit; }
+
+    /**
+     * @brief Diagnósticos descartados por causa do limite.
+     */
+    size_t droppedCount() const { return dropped; }
+
+    bool empty() const { return items.empty() && dropped == 0; }
+    size_t size() const { return items.size(); }
+    const Diagnostic& operator[](size_t i) const { return items[i]; }
+
+    std::vector<Diagnostic>::const_iterator begin() const { return items.begin(); }
+    std::vector<Diagnostic>::const_iterator end() const { return items.end(); }
+
+    void clear() { items.clear(); dropped = 0; }
+
+private:
+    std::vector<Diagnostic> items;
+    size_t limit;
+    size_t dropped;
+};
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,187 @@
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "diagnostics.h"
+#include "source.h"
+#include "simdlexer.h"
+
+/**
+ * @brief Implementação do léxico (selecionável em tempo de execução).
+ */
+enum LexerBackend {
+    LEXER_FLEX,   // lex.yy.c gerado a partir de lexer.l
+    LEXER_SIMD    // SimdLexer (simdlexer.cpp), mesma sequência de tokens
+};
+
+/**
+ * @brief Implementação do parser (selecionável em tempo de execução).
+ */
+enum ParserBackend {
+    PARSER_BISON, // parser.y (LALR)
+    PARSER_RD     // descendente recursivo + Pratt (rdparser.cpp)
+};
+
+/**
+ * @brief Opções do front end (léxico + parser).
+ */
+struct FrontendOptions {
+    LexerBackend lexer;
+    ParserBackend parser;
+    unsigned lexThreads;  // > 1: léxico paralelo (parlexer.h)
+
+    FrontendOptions() : lexer(LEXER_FLEX), parser(PARSER_BISON), lexThreads(1) {}
+};
+
+/**
+ * @brief Avisos do parser sobre partes do programa já completas. Na
+ *        compilação em streaming elas são analisadas enquanto o resto do
+ *        fonte ainda não chegou.
+ */
+class ParseListener {
+public:
+    virtual ~ParseListener() {}
+    virtual void declarationsDone() {}  // chegou o "config"
+    virtual void configDone() {}        // chegou o "fim" de config
+
+    /**
+     * @brief Um comando de nível superior de config (`loop` = false) ou
+     *        de repita ficou completo, com os seus sub-blocos.
+     * @return true se o listener consumiu o comando: ele não entra na
+     *         lista do AST, e o listener pode descartar os nós dele.
+     */
+    virtual bool statement(const Command& cmd, bool loop) { (void)cmd; (void)loop; return false; }
+};
+
+/**
+ * @brief Estado de uma análise sintática. Todo o estado mutável do
+ *        front end vive aqui (e no scanner reentrante do flex), de modo
+ *        que cada thread pode compilar o seu próprio programa.
+ */
+struct ParseContext {
+    ASTProgram* program;  // AST sendo construído
+    DiagnosticList* diagnostics;  // erros léxicos e de sintaxe
+
+    /*
+     * Em qual bloco estamos
+     * 0 = nenhum, 1 = config, 2 = repita
+     */
+    int currentBlock;
+
+    // Sub-blocos abertos (se/senão/enquanto), do mais externo ao atual
+    std::vector<BlockId> openBlocks;
+
+    // Léxico em uso: o scanner do flex (yyscan_t), o SimdLexer ou
+    // tokens já prontos (léxico paralelo), entregues em ordem
+    void* scanner;
+    SimdLexer* simd;
+    const Token* replay;
+    const Token* replayEnd;
+    Token lastToken;      // último token entregue (mensagens de erro)
+
+    ParseListener* listener;  // opcional (StreamParser)
+    bool frontendError;       // já houve erro léxico ou de sintaxe
+
+    ParseContext(ASTProgram* p, DiagnosticList* d)
+        : program(p), diagnostics(d), currentBlock(0), scanner(NULL), simd(NULL),
+          replay(NULL), replayEnd(NULL), lastToken(), listener(NULL), frontendError(false) {}
+
+    /**
+     * @brief Lista que recebe os comandos reconhecidos agora: o
+     *        sub-bloco mais interno aberto, ou config/repita.
+     */
+    CommandList* currentList() {
+        if (!openBlocks.empty()) return &program->blocks[openBlocks.back()];
+        if (currentBlock == 1) return &program->configCommands;
+        if (currentBlock == 2) return &program->repitaCommands;
+        return NULL;
+    }
+
+    BlockId openBlock() {
+        BlockId id = program->newBlock();
+        openBlocks.push_back(id);
+        return id;
+    }
+    void closeBlock() { openBlocks.pop_back(); }
+};
+
+/**
+ * @brief Executa léxico + parser sobre `source`, preenchendo `program`.
+ *        O flex lê direto do buffer (yy_scan_buffer), sem cópia.
+ *        Reentrante: pode ser chamada em paralelo com ASTs distintos.
+ *
+ * Com `lexThreads` > 1, a entrada é dividida em fatias varridas em
+ * paralelo pelo SimdLexer (ver parlexer.h), qualquer que seja `lexer`.
+ * O parser PARSER_RD sempre lê os tokens do SimdLexer.
+ *
+ * Caracteres inválidos e o erro de sintaxe vão para `diagnostics`;
+ * nada é impresso.
+ *
+ * @return 0 em caso de sucesso (mesmo código de yyparse()).
+ */
+int parseProgram(SourceBuffer& source, ASTProgram& program, DiagnosticList& diagnostics,
+                 const FrontendOptions& options = FrontendOptions());
+
+struct yypstate;
+
+/**
+ * @brief Front end incremental: recebe o fonte em pedaços de qualquer
+ *        tamanho (ex.: lidos de um pipe) e entrega os tokens ao parser
+ *        Bison em modo push assim que eles ficam completos.
+ *
+ * Só a parte do buffer até a última quebra de linha é varrida (pelo
+ * SimdLexer): um token nunca atravessa um '\n', exceto uma string, e
+ * uma aspa sem fechamento espera pelo próximo pedaço. Os bytes já
+ * consumidos são descartados, então a memória não cresce com a entrada.
+ * O AST e os diagnósticos são os mesmos de parseProgram() com o parser
+ * Bison.
+ */
+class StreamParser {
+public:
+    StreamParser(ASTProgram& program, DiagnosticList& diagnostics, ParseListener* listener = NULL);
+    ~StreamParser();
+
+    /**
+     * @brief Acrescenta um pedaço do fonte e analisa o que já está completo.
+     * @return false se a análise já terminou (abandonada ou concluída).
+     */
+    bool feed(const char* data, size_t length);
+
+    /**
+     * @brief Fim da entrada: analisa o resto e o fim de arquivo.
+     * @return 0 em caso de sucesso (mesmo código de yyparse()).
+     */
+    int finish();
+
+    /**
+     * @brief true depois do primeiro erro léxico ou de sintaxe (o AST
+     *        lido deixa de ser confiável).
+     */
+    bool frontendError() const { return ctx.frontendError; }
+
+private:
+    ParseContext ctx;
+    yypstate* state;
+    std::string pending;  // fonte recebido e ainda não varrido
+    int line;             // linha no início de `pending`
+    bool openQuote;       // `pending` começa numa aspa ainda sem par
+    int status;           // YYPUSH_MORE enquanto a análise continua
+
+    void scan(const char* end, bool last);
+    bool push(const Token& tok);
+
+    StreamParser(const StreamParser&) = delete;
+    StreamParser& operator=(const StreamParser&) = delete;
+};
+
+/**
+ * @brief Registra um erro de sintaxe no último token lido (ctx->lastToken
+ *        ou o token atual do flex) em ctx->diagnostics. Usado pelos dois
+ *        parsers, para que as mensagens sejam idênticas.
+ */
+void yyerror(ParseContext* ctx, const char *s);
+
+#endif // FRONTEND_H
@@ -0,0 +1,366 @@
+#include "hoist.h"
+#include "pinflow.h"
+#include "trace.h"
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief O que os configurar/configurarPWM de repita fazem com um pino
+ *        (iguais podem se repetir; diferentes se desfazem).
+ */
+enum PinConfigSig : uint8_t {
+    SIG_NONE,     // não é configurado em repita
+    SIG_SAIDA,
+    SIG_ENTRADA,
+    SIG_PWM,
+    SIG_MIXED     // configurado de mais de um jeito
+};
+
+/**
+ * @brief Decide, comando a comando de nível superior de repita, o que
+ *        sobe para config (hoist.h).
+ */
+class Hoister {
+public:
+    Hoister(ASTProgram& p, DiagnosticList& w);
+
+    size_t run();
+
+private:
+    ASTProgram& program;
+    DiagnosticList& warnings;
+    const SymbolTable& symbols;
+    size_t warned;
+
+    // Pinos com o mesmo número constante ficam na mesma classe
+    // (constantPinClasses); os outros não têm classe (podem ser qualquer um)
+    std::vector<uint32_t> pinClass;
+
+    // Todo o repita
+    std::vector<uint32_t> writes;        // escritas de cada variável
+    std::vector<uint8_t> configSig;      // PinConfigSig de cada pino
+    std::vector<uint32_t> classConfigs;  // pinos configurados em cada classe
+    uint32_t configured;                 // pinos configurados
+    uint32_t configuredUnknown;          // ... sem classe
+    const WifiCmd* wifi;                 // primeiro conectarWifi
+    bool wifiMixed;                      // outro conectarWifi com outra rede
+
+    // Comandos que ficam em repita, antes do atual
+    std::vector<uint8_t> readBefore;     // variável lida
+    std::vector<uint8_t> classUsed;      // pino da classe usado
+    uint32_t usedUnknown;                // pinos sem classe usados
+    uint32_t usedAny;                    // pinos usados
+    std::vector<uint8_t> pinUsed;        // por SymbolId (conta cada pino uma vez)
+    bool httpBefore;
+
+    std::vector<const Expr*> stack;
+
+    void scan(const Command& cmd);
+    void scanList(const CommandList& cmds) {
+        for (const Command& c : cmds) scan(c);
+    }
+    void configPin(SymbolId pin, PinConfigSig sig);
+
+    void before(const Command& cmd, bool nested);
+    void beforeList(const CommandList& cmds) {
+        for (const Command& c : cmds) before(c, true);
+    }
+    void readExpr(const Expr* root);
+    void usePin(SymbolId pin);
+
+    bool maybeAliased(SymbolId pin) const;
+    bool usedBefore(SymbolId pin) const;
+    bool invariant(const Expr* root);
+    bool safeToMove(const Expr* root);
+    bool hoistable(const Command& cmd, std::string& reason);
+    void warn(const Command& cmd, const std::string& reason);
+};
+
+Hoister::Hoister(ASTProgram& p, DiagnosticList& w)
+    : program(p), warnings(w), symbols(p.symbols), warned(0),
+      pinClass(constantPinClasses(p)), writes(p.names.size(), 0),
+      configSig(p.names.size(), SIG_NONE), classConfigs(p.names.size(), 0), configured(0),
+      configuredUnknown(0), wifi(NULL), wifiMixed(false), readBefore(p.names.size(), 0),
+      classUsed(p.names.size(), 0), usedUnknown(0), usedAny(0), pinUsed(p.names.size(), 0),
+      httpBefore(false) {}
+
+/* -------------------------------------------------
+ * 1) O que todo o repita faz
+ * ------------------------------------------------- */
+void Hoister::configPin(SymbolId pin, PinConfigSig sig) {
+    if (configSig[pin] == SIG_NONE) {
+        configured++;
+        if (pinClass[pin] == NO_PIN_CLASS) configuredUnknown++;
+        else classConfigs[pinClass[pin]]++;
+        configSig[pin] = sig;
+    } else if (configSig[pin] != sig) {
+        configSig[pin] = SIG_MIXED;
+    }
+}
+
+void Hoister::scan(const Command& cmd) {
+    switch (cmd.cmdType) {
+        case CMD_ASSIGN:
+            writes[cmd.assign.var]++;
+            break;
+        case CMD_LER_DIGITAL:
+        case CMD_LER_ANALOGICO:
+            writes[cmd.readPin.var]++;
+            break;
+        case CMD_CONFIG_PIN:
+            configPin(cmd.configPin.pin, cmd.configPin.mode == PINO_ENTRADA ? SIG_ENTRADA : SIG_SAIDA);
+            break;
+        case CMD_CONFIG_PWM:
+            configPin(cmd.configPwm.pin, SIG_PWM);
+            break;
+        case CMD_WIFI_CONNECT:
+            if (!wifi) {
+                wifi = &cmd.wifi;
+            } else if (cmd.wifi.ssid != wifi->ssid || cmd.wifi.password != wifi->password) {
+                wifiMixed = true;
+            }
+            break;
+        case CMD_IF:
+        case CMD_WHILE:
+            scanList(program.block(cmd.cond.body));
+            if (cmd.cond.elseBody != NO_BLOCK) scanList(program.block(cmd.cond.elseBody));
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------
+ * 2) O que os comandos que ficam usam antes do atual
+ * ------------------------------------------------- */
+void Hoister::readExpr(const Expr* root) {
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Expr* e = stack.back();
+        stack.pop_back();
+        if (e->kind == EXPR_IDENT) readBefore[e->symbol] = 1;
+        if (e->left) stack.push_back(e->left);
+        if (e->right) stack.push_back(e->right);
+    }
+}
+
+void Hoister::usePin(SymbolId pin) {
+    readBefore[pin] = 1;
+    if (pinUsed[pin]) return;
+    pinUsed[pin] = 1;
+    usedAny++;
+    if (pinClass[pin] == NO_PIN_CLASS) usedUnknown++;
+    else classUsed[pinClass[pin]] = 1;
+}
+
+void Hoister::before(const Command& cmd, bool nested) {
+    switch (cmd.cmdType) {
+        case CMD_ASSIGN:
+            readExpr(cmd.assign.value);
+            break;
+        case CMD_LER_DIGITAL:
+        case CMD_LER_ANALOGICO:
+            usePin(cmd.readPin.pin);
+            break;
+        case CMD_CONFIG_PIN:
+            // Um configurar igual, antes, não muda nada; um diferente já
+            // impede (maybeAliased)
+            readBefore[cmd.configPin.pin] = 1;
+            if (nested) warn(cmd, "está dentro de se/enquanto");
+            break;
+        case CMD_CONFIG_PWM:
+            readBefore[cmd.configPwm.pin] = 1;
+            if (nested) warn(cmd, "está dentro de se/enquanto");
+            break;
+        case CMD_PWM_ADJUST:
+            usePin(cmd.pwmAdjust.pin);
+            readExpr(cmd.pwmAdjust.value);
+            break;
+        case CMD_LIGAR:
+        case CMD_DESLIGAR:
+            usePin(cmd.digital.pin);
+            break;
+        case CMD_WIFI_CONNECT:
+            readBefore[cmd.wifi.ssid] = 1;
+            readBefore[cmd.wifi.password] = 1;
+            if (nested) warn(cmd, "está dentro de se/enquanto");
+            break;
+        case CMD_WAIT:
+            readExpr(cmd.wait.time);
+            break;
+        case CMD_ENVIAR_HTTP:
+            httpBefore = true;
+            break;
+        case CMD_IF:
+        case CMD_WHILE:
+            readExpr(cmd.cond.condition);
+            beforeList(program.block(cmd.cond.body));
+            if (cmd.cond.elseBody != NO_BLOCK) beforeList(program.block(cmd.cond.elseBody));
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------
+ * 3) Regras de cada comando
+ * ------------------------------------------------- */
+/**
+ * @brief true se outro pino configurado em repita pode ter o mesmo número.
+ */
+bool Hoister::maybeAliased(SymbolId pin) const {
+    if (pinClass[pin] == NO_PIN_CLASS) return configured > 1;
+    return configuredUnknown > 0 || classConfigs[pinClass[pin]] > 1;
+}
+
+/**
+ * @brief true se um comando que fica, antes do atual, usa um pino que
+ *        pode ser `pin`.
+ */
+bool Hoister::usedBefore(SymbolId pin) const {
+    if (pinClass[pin] == NO_PIN_CLASS) return usedAny > 0;
+    return usedUnknown > 0 || classUsed[pinClass[pin]];
+}
+
+/**
+ * @brief true se nenhuma variável de `root` é escrita em repita.
+ */
+bool Hoister::invariant(const Expr* root) {
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Expr* e = stack.back();
+        stack.pop_back();
+        if (e->kind == EXPR_IDENT && writes[e->symbol] != 0) return false;
+        if (e->left) stack.push_back(e->left);
+        if (e->right) stack.push_back(e->right);
+    }
+    return true;
+}
+
+/**
+ * @brief true se `root` não divide por zero nem estoura na divisão (só
+ *        divisores literais diferentes de 0 e -1).
+ */
+bool Hoister::safeToMove(const Expr* root) {
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Expr* e = stack.back();
+        stack.pop_back();
+        if (e->kind == EXPR_BINARIA && e->op == OP_DIV) {
+            const Expr* d = e->right;
+            while (d->kind == EXPR_PARENTESES) d = d->left;
+            if (d->kind != EXPR_NUMERO || d->value == 0 || d->value == -1) return false;
+        }
+        if (e->left) stack.push_back(e->left);
+        if (e->right) stack.push_back(e->right);
+    }
+    return true;
+}
+
+/**
+ * @brief true se `cmd` (de nível superior) pode subir; senão, `reason`
+ *        diz por que (vazio para atribuições, que não geram aviso).
+ */
+bool Hoister::hoistable(const Command& cmd, std::string& reason) {
+    switch (cmd.cmdType) {
+        case CMD_ASSIGN: {
+            SymbolId var = cmd.assign.var;
+            return writes[var] == 1 && !readBefore[var] && invariant(cmd.assign.value)
+                   && safeToMove(cmd.assign.value);
+        }
+        case CMD_CONFIG_PIN:
+        case CMD_CONFIG_PWM: {
+            SymbolId pin = cmd.cmdType == CMD_CONFIG_PIN ? cmd.configPin.pin : cmd.configPwm.pin;
+            if (writes[pin] != 0) {
+                reason = std::string("'") + program.names.cstr(pin) + "' muda em repita";
+            } else if (configSig[pin] == SIG_MIXED || maybeAliased(pin)) {
+                reason = "outro comando de repita configura um pino que pode ser o mesmo";
+            } else if (usedBefore(pin)) {
+                reason = "um comando anterior de repita já usa o pino";
+            } else {
+                return true;
+            }
+            return false;
+        }
+        case CMD_WIFI_CONNECT: {
+            const WifiCmd& w = cmd.wifi;
+            if (writes[w.ssid] != 0 || writes[w.password] != 0) {
+                SymbolId changed = writes[w.ssid] != 0 ? w.ssid : w.password;
+                reason = std::string("'") + program.names.cstr(changed) + "' muda em repita";
+            } else if (wifiMixed) {
+                reason = "outro conectarWifi de repita usa outra rede";
+            } else if (httpBefore) {
+                reason = "um enviarHttp anterior de repita depende da conexão";
+            } else {
+                return true;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+void Hoister::warn(const Command& cmd, const std::string& reason) {
+    const StringInterner& names = program.names;
+    std::string text;
+    switch (cmd.cmdType) {
+        case CMD_CONFIG_PIN:
+            text = std::string("configurar ") + names.cstr(cmd.configPin.pin) + " como "
+                   + pinModeName(cmd.configPin.mode);
+            break;
+        case CMD_CONFIG_PWM:
+            text = std::string("configurarPWM ") + names.cstr(cmd.configPwm.pin);
+            break;
+        default:
+            text = std::string("conectarWifi ") + names.cstr(cmd.wifi.ssid) + " "
+                   + names.cstr(cmd.wifi.password);
+            break;
+    }
+    warnings.report(DIAG_AVISO, cmd.line, "Aviso: '%s' fica em repita: %s. (linha %d)", text.c_str(),
+                    reason.c_str(), cmd.line);
+    warned++;
+}
+
+size_t Hoister::run() {
+    CommandList& loop = program.repitaCommands;
+    scanList(loop);
+
+    std::vector<uint8_t> moved(loop.size(), 0);
+    size_t count = 0;
+    for (size_t i = 0; i < loop.size(); i++) {
+        const Command& cmd = loop[i];
+        std::string reason;
+        if (hoistable(cmd, reason)) {
+            // Em config, a escrita não conta mais para os comandos seguintes
+            if (cmd.cmdType == CMD_ASSIGN) writes[cmd.assign.var]--;
+            moved[i] = 1;
+            count++;
+            continue;
+        }
+        if (!reason.empty()) warn(cmd, reason);
+        before(cmd, false);
+    }
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "Invariantes: %zu comandos levados de repita para config, %zu avisos",
+          count, warned);
+    if (count == 0) return 0;
+
+    // Os que sobem vão para o fim de config, na ordem de repita
+    CommandList kept(ArenaAllocator<Command>(&program.arena));
+    kept.reserve(loop.size() - count);
+    for (size_t i = 0; i < loop.size(); i++) {
+        if (moved[i]) program.configCommands.push_back(loop[i]);
+        else kept.push_back(loop[i]);
+    }
+    loop = std::move(kept);
+    return count;
+}
+
+size_t hoistInvariants(ASTProgram& program, DiagnosticList& warnings) {
+    return Hoister(program, warnings).run();
+}
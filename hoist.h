@@ -0,0 +1,37 @@
+#ifndef HOIST_H
+#define HOIST_H
+
+#include <stddef.h>
+#include "ast.h"
+#include "diagnostics.h"
+
+/**
+ * @brief Leva de repita para o fim de config os comandos que fazem a
+ *        mesma coisa em toda volta de loop(): `configurar`,
+ *        `configurarPWM`, `conectarWifi` e atribuições de valor
+ *        invariante (ex.: `limite = 200;`). Roda entre a análise
+ *        semântica (e a dobra de constantes) e a geração de código; os
+ *        grafos precisam ser refeitos depois.
+ *
+ * Um comando de nível superior de repita sobe quando:
+ * - o que ele lê não é escrito em repita (nem pelo próprio comando);
+ * - nenhum outro comando de repita desfaz o que ele faz: outra escrita
+ *   na variável, outro configurar/configurarPWM diferente num pino que
+ *   pode ser o mesmo, outro conectarWifi com outra rede;
+ * - nenhum comando que fica e vem antes dele em repita usa o que ele faz
+ *   (a primeira volta veria o valor/pino/WiFi de antes). Ex.: `ligar led;`
+ *   antes de `configurar led como saida;` segura o configurar.
+ *
+ * Dois pinos só são certamente diferentes quando as duas variáveis são
+ * constantes (constprop.h) com números diferentes. Uma atribuição não
+ * sobe se o valor divide por algo que não seja um literal (a divisão por
+ * zero aconteceria antes de comandos que vinham antes dela).
+ *
+ * Cada configurar/configurarPWM/conectarWifi de repita que não sobe
+ * (inclusive dentro de se/enquanto) gera um aviso com o motivo.
+ *
+ * @return Número de comandos levados para config.
+ */
+size_t hoistInvariants(ASTProgram& program, DiagnosticList& warnings);
+
+#endif // HOIST_H
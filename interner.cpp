@@ -0,0 +1,76 @@
+#include "interner.h"
+
+static const size_t INITIAL_SLOTS = 64;
+
+/**
+ * @brief FNV-1a de 32 bits.
+ */
+static uint32_t hashText(const char* text, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)text[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Posição de `text` na tabela, ou do slot vazio onde ele entraria
+ *        (sondagem linear).
+ */
+size_t StringInterner::findSlot(std::string_view text, uint32_t hash) const {
+    size_t i = hash & mask;
+    for (;;) {
+        SymbolId id = slots[i];
+        if (id == NO_SYMBOL || (hashes[id] == hash && names[id] == text)) {
+            return i;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+void StringInterner::grow() {
+    size_t newSize = slots.empty() ? INITIAL_SLOTS : slots.size() * 2;
+    slots.assign(newSize, NO_SYMBOL);
+    mask = newSize - 1;
+    for (SymbolId id = 0; id < (SymbolId)names.size(); id++) {
+        size_t i = hashes[id] & mask;
+        while (slots[i] != NO_SYMBOL) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+}
+
+SymbolId StringInterner::intern(const char* text, size_t len) {
+    // Mantém a tabela no máximo meio cheia
+    if ((names.size() + 1) * 2 > slots.size()) {
+        grow();
+    }
+
+    std::string_view key(text, len);
+    uint32_t hash = hashText(text, len);
+    size_t slot = findSlot(key, hash);
+    if (slots[slot] != NO_SYMBOL) {
+        return slots[slot];
+    }
+
+    SymbolId id = (SymbolId)names.size();
+    names.push_back(std::string_view(arena.copyString(text, len), len));
+    hashes.push_back(hash);
+    slots[slot] = id;
+    return id;
+}
+
+SymbolId StringInterner::lookup(std::string_view text) const {
+    if (slots.empty()) {
+        return NO_SYMBOL;
+    }
+    return slots[findSlot(text, hashText(text.data(), text.size()))];
+}
+
+void StringInterner::clear() {
+    names.clear();
+    hashes.clear();
+    if (!slots.empty()) {
+        slots.assign(slots.size(), NO_SYMBOL);
+    }
+}
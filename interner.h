@@ -0,0 +1,70 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+#include "arena.h"
+
+/**
+ * @brief Identificador compacto de um nome (variável/pino).
+ *        Dois SymbolId iguais <=> mesmo texto.
+ */
+typedef uint32_t SymbolId;
+
+const SymbolId NO_SYMBOL = 0xFFFFFFFFu;
+
+/**
+ * @brief Tabela de internação de identificadores.
+ *
+ * O léxico interna cada IDENTIFICADOR uma única vez; parser, análise
+ * semântica e geração de código trabalham só com o SymbolId e comparam
+ * inteiros em vez de strings. IDs são densos (0, 1, 2, ...) na ordem
+ * em que os nomes aparecem no fonte.
+ *
+ * O texto de cada nome é copiado (com NUL no fim) para a Arena da
+ * compilação; o índice é uma tabela de espalhamento aberta, então
+ * internar um nome novo não faz uma alocação por nome.
+ */
+class StringInterner {
+public:
+    explicit StringInterner(Arena& a) : arena(a), mask(0) {}
+
+    /**
+     * @brief Retorna o ID de `text`, criando-o se ainda não existir.
+     */
+    SymbolId intern(const char* text, size_t len);
+    SymbolId intern(std::string_view text) { return intern(text.data(), text.size()); }
+
+    /**
+     * @brief Busca sem inserir.
+     * @return O ID, ou NO_SYMBOL se o nome nunca foi internado.
+     */
+    SymbolId lookup(std::string_view text) const;
+
+    /**
+     * @brief Texto original de um ID.
+     */
+    std::string_view name(SymbolId id) const { return names[id]; }
+    const char* cstr(SymbolId id) const { return names[id].data(); }
+
+    size_t size() const { return names.size(); }
+
+    /**
+     * @brief Esquece todos os nomes (o texto pertence à arena, que é
+     *        liberada à parte).
+     */
+    void clear();
+
+private:
+    Arena& arena;
+    std::vector<std::string_view> names;  // ID -> texto (na arena)
+    std::vector<uint32_t> hashes;         // ID -> hash do texto
+    std::vector<SymbolId> slots;          // tabela aberta (NO_SYMBOL = vazio)
+    size_t mask;                          // slots.size() - 1
+
+    size_t findSlot(std::string_view text, uint32_t hash) const;
+    void grow();
+};
+
+#endif // INTERNER_H
@@ -0,0 +1,58 @@
+#include "ledc.h"
+#include "trace.h"
+#include <unordered_map>
+#include <vector>
+
+bool ledcTimingOk(int freq, int resol) {
+    if (freq <= 0 || resol <= 0 || resol > LEDC_MAX_RESOL) return false;
+    return (int64_t)freq << resol <= LEDC_CLOCK_HZ;
+}
+
+bool allocateLedc(SymbolTable& symbols, const StringInterner& names, DiagnosticList& diagnostics) {
+    // Pinos PWM na ordem do primeiro configurarPWM (o canal provisório)
+    std::vector<SymbolId> order(symbols.pwmCount());
+    for (SymbolId id = 0; id < symbols.size(); id++) {
+        if (symbols.hasPwm(id)) order[symbols.pwmChannel(id)] = id;
+    }
+
+    // Grupo (freq, resol) -> canal livre no último temporizador dele
+    std::unordered_map<uint64_t, int> open;
+    int timers = 0;
+    SymbolId first = 0;  // primeiro pino que não coube
+    for (SymbolId id : order) {
+        uint64_t key = (uint64_t)(uint32_t)symbols.pwmFreq(id) << 32 | (uint32_t)symbols.pwmResol(id);
+        auto slot = open.find(key);
+        if (slot != open.end()) {
+            symbols.setPwmChannel(id, slot->second);
+            open.erase(slot);
+            continue;
+        }
+        if (timers == LEDC_TIMERS) first = id;
+        symbols.setPwmChannel(id, 2 * timers);
+        open[key] = 2 * timers + 1;
+        timers++;
+    }
+
+    TRACE(TRACE_SEMANTIC, TRACE_INFO, "LEDC: %zu canais PWM em %d temporizadores",
+          order.size(), timers);
+    if (timers > LEDC_TIMERS) {
+        // Na linha do configurarPWM do primeiro pino que não coube
+        int line = symbols.pwmLine(first);
+        diagnostics.report(DIAG_SEMANTICO, line,
+                           "Erro semântico: PWM de '%s' não cabe no ESP32: os %zu pinos PWM precisam de "
+                           "%d temporizadores LEDC e há %d (%d canais; só pinos com a mesma frequência "
+                           "e resolução dividem um temporizador). (linha %d)",
+                           names.cstr(first), order.size(), timers, LEDC_TIMERS, LEDC_CHANNELS, line);
+        return false;
+    }
+    return true;
+}
+
+size_t ledcTimerCount(const SymbolTable& symbols) {
+    size_t timers = 0;
+    for (SymbolId id = 0; id < symbols.size(); id++) {
+        // Todo temporizador usado tem um pino no seu primeiro canal
+        if (symbols.hasPwm(id) && symbols.pwmChannel(id) % 2 == 0) timers++;
+    }
+    return timers;
+}
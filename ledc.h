@@ -0,0 +1,53 @@
+#ifndef LEDC_H
+#define LEDC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "diagnostics.h"
+#include "interner.h"
+#include "symtab.h"
+
+/* -------------------------------------------------
+ * 1) LEDC do ESP32
+ * ------------------------------------------------- */
+const int LEDC_CHANNELS = 16;            // 8 de alta e 8 de baixa velocidade
+const int LEDC_TIMERS = 8;               // 4 por grupo, cada um com 2 canais
+const int LEDC_MAX_RESOL = 20;           // bits
+const int64_t LEDC_CLOCK_HZ = 80000000;  // APB: freq * 2^resol não passa disso
+
+/**
+ * @brief Temporizador de um canal: no núcleo Arduino do ESP32, ledcSetup()
+ *        dos canais 2k e 2k+1 configura o mesmo temporizador (o k % 4 do
+ *        grupo k / 4), então os dois precisam da mesma frequência e
+ *        resolução.
+ */
+inline int ledcTimer(int channel) { return channel / 2; }
+
+/**
+ * @brief true se um temporizador gera `freq` Hz com `resol` bits.
+ */
+bool ledcTimingOk(int freq, int resol);
+
+/* -------------------------------------------------
+ * 2) Alocação dos canais
+ * ------------------------------------------------- */
+/**
+ * @brief Troca o canal provisório de cada pino PWM (a ordem do primeiro
+ *        configurarPWM, SymbolTable::addPwm) pelo canal do LEDC.
+ *
+ * Os pinos são agrupados por (frequência, resolução): na ordem do fonte,
+ * um pino fica no segundo canal do temporizador do seu grupo, se ainda
+ * está livre, ou abre um temporizador novo. Assim 16 pinos com a mesma
+ * frequência e resolução cabem num ESP32, e cada combinação diferente
+ * gasta pelo menos um dos 8 temporizadores.
+ *
+ * @return false (com um erro semântico) se os pinos não cabem.
+ */
+bool allocateLedc(SymbolTable& symbols, const StringInterner& names, DiagnosticList& diagnostics);
+
+/**
+ * @brief Temporizadores usados pelos pinos PWM (depois de allocateLedc).
+ */
+size_t ledcTimerCount(const SymbolTable& symbols);
+
+#endif // LEDC_H
@@ -0,0 +1,175 @@
+#include "lexbench.h"
+#include "lexer.h"
+#include "simdlexer.h"
+#include "parlexer.h"
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Um token na forma comparável entre os dois léxicos.
+ */
+struct LexedToken {
+    int kind;
+    int line;
+    std::string text;
+    int intval;
+};
+
+static bool hasIntValue(int kind) {
+    return kind == NUMERO || kind == LIGAR || kind == DESLIGAR;
+}
+
+/**
+ * @brief Varre `source` com o flex. Se `out` for NULL, só conta os tokens.
+ */
+static size_t scanWithFlex(SourceBuffer& source, std::vector<LexedToken>* out) {
+    ASTProgram scratch;                // recebe os identificadores internados
+    DiagnosticList ignored;            // caracteres inválidos viram tokens ERRO
+    ParseContext ctx(&scratch, &ignored);
+    yyscan_t scanner;
+    if (yylex_init_extra(&ctx, &scanner) != 0) {
+        return 0;
+    }
+    YY_BUFFER_STATE buffer = yy_scan_buffer(source.data, source.size + 2, scanner);
+
+    size_t count = 0;
+    YYSTYPE value;
+    int kind;
+    while ((kind = flexScan(&value, scanner)) != 0) {
+        count++;
+        if (out != NULL) {
+            LexedToken t;
+            t.kind = kind;
+            t.line = yyget_lineno(scanner);
+            t.text.assign(yyget_text(scanner), yyget_leng(scanner));
+            t.intval = hasIntValue(kind) ? value.intval : 0;
+            out->push_back(t);
+        }
+    }
+
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    return count;
+}
+
+/**
+ * @brief Varre `source` com o SimdLexer. Se `out` for NULL, só conta os tokens.
+ */
+static size_t scanWithSimd(SourceBuffer& source, std::vector<LexedToken>* out) {
+    SimdLexer lexer(source.data, source.data + source.size);
+    size_t count = 0;
+    Token tok;
+    for (lexer.next(tok); tok.kind != 0; lexer.next(tok)) {
+        count++;
+        if (out != NULL) {
+            LexedToken t;
+            t.kind = tok.kind;
+            t.line = tok.line;
+            t.text.assign(tok.text, tok.length);
+            t.intval = hasIntValue(tok.kind) ? tok.intval : 0;
+            out->push_back(t);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Varre `source` com o léxico paralelo. Se `out` for NULL, só conta os tokens.
+ */
+static size_t scanWithParallel(SourceBuffer& source, unsigned threads,
+                               std::vector<LexedToken>* out) {
+    std::vector<Token> tokens;
+    lexParallel(source.data, source.data + source.size, threads, tokens);
+    size_t count = tokens.size() - 1;  // sem o token final
+    if (out != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            const Token& tok = tokens[i];
+            LexedToken t;
+            t.kind = tok.kind;
+            t.line = tok.line;
+            t.text.assign(tok.text, tok.length);
+            t.intval = hasIntValue(tok.kind) ? tok.intval : 0;
+            out->push_back(t);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Compara a saída de um léxico (`label`) com a do flex.
+ */
+static bool sameTokens(SourceBuffer& source, const std::vector<LexedToken>& expected,
+                       const std::vector<LexedToken>& actual, const std::string& label) {
+    size_t n = expected.size() < actual.size() ? expected.size() : actual.size();
+    for (size_t i = 0; i < n; i++) {
+        const LexedToken& e = expected[i];
+        const LexedToken& a = actual[i];
+        if (e.kind != a.kind || e.line != a.line || e.text != a.text || e.intval != a.intval) {
+            std::cerr << source.name << ": token " << i << " diverge (linha " << e.line << ")\n"
+                      << "  flex: tipo " << e.kind << " \"" << e.text << "\" linha " << e.line << "\n"
+                      << "  " << label << ": tipo " << a.kind << " \"" << a.text << "\" linha " << a.line << "\n";
+            return false;
+        }
+    }
+    if (expected.size() != actual.size()) {
+        std::cerr << source.name << ": flex gerou " << expected.size()
+                  << " tokens, " << label << " gerou " << actual.size() << "\n";
+        return false;
+    }
+
+    std::cout << source.name << ": " << expected.size()
+              << " tokens idênticos (flex x " << label << ")\n";
+    return true;
+}
+
+bool lexerCheck(SourceBuffer& source, unsigned threads) {
+    std::vector<LexedToken> expected, actual;
+    scanWithFlex(source, &expected);
+    scanWithSimd(source, &actual);
+    if (!sameTokens(source, expected, actual, std::string("simd/") + simdLexerIsa())) {
+        return false;
+    }
+    if (threads > 1) {
+        actual.clear();
+        scanWithParallel(source, threads, &actual);
+        return sameTokens(source, expected, actual,
+                          "simd/" + std::string(simdLexerIsa()) + " x" + std::to_string(threads));
+    }
+    return true;
+}
+
+void lexerBenchmark(SourceBuffer& source, int rounds, unsigned threads) {
+    typedef std::chrono::steady_clock Clock;
+    std::string parallelName = "simd x" + std::to_string(threads);
+    const char* names[3] = { "flex", "simd", parallelName.c_str() };
+    double seconds[3];
+    size_t tokens[3] = { 0, 0, 0 };
+    int backends = threads > 1 ? 3 : 2;
+
+    for (int b = 0; b < backends; b++) {
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < rounds; r++) {
+            tokens[b] = b == 0 ? scanWithFlex(source, NULL)
+                      : b == 1 ? scanWithSimd(source, NULL)
+                               : scanWithParallel(source, threads, NULL);
+        }
+        seconds[b] = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    double mb = (double)source.size * rounds / (1024.0 * 1024.0);
+    std::cout << source.name << ": " << source.size << " bytes, " << rounds << " rodada(s)\n";
+    for (int b = 0; b < backends; b++) {
+        std::cout << "  " << names[b] << ": " << tokens[b] << " tokens, "
+                  << (size_t)(tokens[b] * rounds / seconds[b]) << " tokens/s, "
+                  << mb / seconds[b] << " MB/s\n";
+    }
+    std::cout << "  aceleração simd/" << simdLexerIsa() << ": "
+              << seconds[0] / seconds[1] << "x\n";
+    if (threads > 1) {
+        std::cout << "  aceleração " << parallelName << " (sobre simd): "
+                  << seconds[1] / seconds[2] << "x\n";
+    }
+}
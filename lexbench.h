@@ -0,0 +1,21 @@
+#ifndef LEXBENCH_H
+#define LEXBENCH_H
+
+#include "source.h"
+
+/**
+ * @brief Roda o léxico do flex e o SimdLexer sobre a mesma entrada e
+ *        compara token a token (tipo, lexema, valor e linha). Com
+ *        `threads` > 1 compara também o léxico paralelo (parlexer.h).
+ * @return true se as sequências forem idênticas.
+ */
+bool lexerCheck(SourceBuffer& source, unsigned threads = 1);
+
+/**
+ * @brief Mede tokens/segundo (e MB/s) dos léxicos sobre a entrada,
+ *        repetindo a varredura `rounds` vezes, e imprime o resultado.
+ *        Com `threads` > 1 mede também o léxico paralelo.
+ */
+void lexerBenchmark(SourceBuffer& source, int rounds, unsigned threads = 1);
+
+#endif // LEXBENCH_H
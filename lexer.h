@@ -0,0 +1,29 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <stdio.h>
+#include "parser.tab.h"
+
+/*
+ * Interface do léxico reentrante gerado pelo flex (lex.yy.c).
+ * O flex não gera este cabeçalho sozinho sem --header-file,
+ * então declaramos aqui apenas o que o parser usa.
+ */
+#ifndef YY_TYPEDEF_YY_BUFFER_STATE
+#define YY_TYPEDEF_YY_BUFFER_STATE
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
+#endif
+
+// yylex do flex, renomeado (YY_DECL em lexer.l): o yylex do parser
+// escolhe entre ele e o SimdLexer
+int flexScan(YYSTYPE* yylval_param, yyscan_t yyscanner);
+int yylex_init_extra(ParseContext* extra, yyscan_t* scanner);
+int yylex_destroy(yyscan_t scanner);
+void yyset_in(FILE* in, yyscan_t scanner);
+YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, yyscan_t scanner);
+void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
+char* yyget_text(yyscan_t scanner);
+int yyget_leng(yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
+
+#endif // LEXER_H
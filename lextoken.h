@@ -0,0 +1,21 @@
+#ifndef LEXTOKEN_H
+#define LEXTOKEN_H
+
+#include <stdint.h>
+
+/**
+ * @brief Token "cru" produzido pelos léxicos escritos à mão.
+ *
+ * Não aloca nada: o lexema aponta para dentro do buffer-fonte.
+ * A conversão para YYSTYPE (internar identificadores, copiar
+ * strings) fica a cargo de quem consome o token.
+ */
+struct Token {
+    int kind;           // código do token (parser.tab.h); 0 = fim da entrada
+    int line;           // linha ao final do lexema (mesma regra do yylineno do flex)
+    const char* text;   // início do lexema no buffer-fonte
+    uint32_t length;    // tamanho do lexema em bytes
+    int intval;         // NUMERO, LIGAR (1) e DESLIGAR (0)
+};
+
+#endif // LEXTOKEN_H
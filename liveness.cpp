@@ -0,0 +1,239 @@
+#include "liveness.h"
+#include "trace.h"
+
+const uint32_t NO_LIVE_SLOT = 0xFFFFFFFFu;
+
+// Os conjuntos de todos os blocos ficam num vetor só; acima disso (muitos
+// blocos vezes muitas variáveis) a análise desiste e nada é omitido
+const size_t MAX_LIVE_WORDS = 8u * 1024 * 1024;  // 64 MiB
+
+/**
+ * @brief Conjuntos de variáveis vivas do grafo de repita: um bit por
+ *        variável escrita em repita, `words` palavras por bloco.
+ */
+class Liveness {
+public:
+    explicit Liveness(const ControlFlowGraph& g) : graph(g), variables(0), words(0) {}
+
+    const ControlFlowGraph& graph;
+    uint32_t variables;
+    size_t words;
+    std::vector<uint64_t> liveIn;  // entrada de cada bloco
+    std::vector<uint64_t> live;    // ponto atual da transferência
+
+    /**
+     * @brief Numera as variáveis escritas em repita.
+     * @return false se não há nenhuma (nada a analisar).
+     */
+    bool collect();
+
+    /**
+     * @brief `live` = união das entradas dos sucessores de `id`. O fim de
+     *        loop() segue para o começo (a próxima volta).
+     */
+    void liveOut(BasicBlockId id);
+
+    /**
+     * @brief Leva `live` do fim de `block` para o começo e escreve em
+     *        `dead` (uma posição por comando) quais atribuições estão mortas.
+     */
+    void transfer(const BasicBlock& block, uint8_t* dead);
+
+private:
+    std::vector<uint32_t> slots;  // SymbolId -> bit (NO_LIVE_SLOT se não é escrita)
+    std::vector<const Expr*> stack;
+
+    uint32_t slot(SymbolId id) const { return id < slots.size() ? slots[id] : NO_LIVE_SLOT; }
+    void write(SymbolId id) {
+        if (id >= slots.size()) slots.resize(id + 1, NO_LIVE_SLOT);
+        if (slots[id] == NO_LIVE_SLOT) slots[id] = variables++;
+    }
+    bool isLive(uint32_t s) const { return (live[s >> 6] >> (s & 63)) & 1; }
+    void gen(SymbolId id) {
+        uint32_t s = slot(id);
+        if (s != NO_LIVE_SLOT) live[s >> 6] |= (uint64_t)1 << (s & 63);
+    }
+    void kill(SymbolId id) {
+        uint32_t s = slot(id);
+        live[s >> 6] &= ~((uint64_t)1 << (s & 63));
+    }
+    void genExpr(const Expr* root);
+};
+
+bool Liveness::collect() {
+    for (const BasicBlock& block : graph.blocks) {
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            if (cmd->cmdType == CMD_ASSIGN) write(cmd->assign.var);
+            if (cmd->cmdType == CMD_LER_DIGITAL || cmd->cmdType == CMD_LER_ANALOGICO) {
+                write(cmd->readPin.var);
+            }
+        }
+    }
+    words = ((size_t)variables + 63) / 64;
+    live.assign(words, 0);
+    return variables != 0;
+}
+
+void Liveness::liveOut(BasicBlockId id) {
+    const BasicBlock& block = graph.blocks[id];
+    BasicBlockId succ[2];
+    size_t n = 0;
+    if (block.term == TERM_RETURN) {
+        succ[n++] = graph.entry;
+    } else {
+        succ[n++] = block.next;
+        if (block.term == TERM_BRANCH) succ[n++] = block.other;
+    }
+
+    live.assign(words, 0);
+    for (size_t k = 0; k < n; k++) {
+        const uint64_t* in = &liveIn[succ[k] * words];
+        for (size_t w = 0; w < words; w++) live[w] |= in[w];
+    }
+}
+
+void Liveness::genExpr(const Expr* root) {
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Expr* e = stack.back();
+        stack.pop_back();
+        if (e->kind == EXPR_IDENT) gen(e->symbol);
+        if (e->left) stack.push_back(e->left);
+        if (e->right) stack.push_back(e->right);
+    }
+}
+
+void Liveness::transfer(const BasicBlock& block, uint8_t* dead) {
+    // A condição é avaliada depois dos comandos do bloco
+    if (block.term == TERM_BRANCH) genExpr(block.condition);
+
+    for (size_t i = block.size(); i-- > 0;) {
+        const Command& cmd = block.begin[i];
+        switch (cmd.cmdType) {
+            case CMD_ASSIGN:
+                dead[i] = !isLive(slot(cmd.assign.var));
+                if (dead[i]) break;  // ninguém lê o valor: o lado direito também não conta
+                kill(cmd.assign.var);
+                genExpr(cmd.assign.value);
+                break;
+            case CMD_LER_DIGITAL:
+            case CMD_LER_ANALOGICO:
+                kill(cmd.readPin.var);
+                gen(cmd.readPin.pin);
+                break;
+            case CMD_CONFIG_PIN:
+                gen(cmd.configPin.pin);
+                break;
+            case CMD_CONFIG_PWM:
+                gen(cmd.configPwm.pin);
+                break;
+            case CMD_PWM_ADJUST:
+                gen(cmd.pwmAdjust.pin);
+                genExpr(cmd.pwmAdjust.value);
+                break;
+            case CMD_LIGAR:
+            case CMD_DESLIGAR:
+                gen(cmd.digital.pin);
+                break;
+            case CMD_WIFI_CONNECT:
+                gen(cmd.wifi.ssid);
+                gen(cmd.wifi.password);
+                break;
+            case CMD_WAIT:
+                genExpr(cmd.wait.time);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void DeadStores::run(const ControlFlowGraph& loop) {
+    first.clear();
+    flags.clear();
+    count = 0;
+
+    Liveness live(loop);
+    size_t n = loop.blocks.size();
+    if (!live.collect()) return;
+    if (n * live.words > MAX_LIVE_WORDS) {
+        TRACE(TRACE_CODEGEN, TRACE_INFO, "Vivacidade: %zu blocos x %u variaveis, grande demais",
+              n, live.variables);
+        return;
+    }
+
+    // Predecessores (o começo de repita também vem do fim, pela volta)
+    std::vector<uint32_t> predStart(n + 1, 0);
+    std::vector<BasicBlockId> preds;
+    for (int pass = 0; pass < 2; pass++) {
+        for (BasicBlockId id = 0; id < n; id++) {
+            const BasicBlock& block = loop.blocks[id];
+            BasicBlockId succ[2] = {block.next, block.other};
+            size_t k = block.term == TERM_BRANCH ? 2 : 1;
+            if (block.term == TERM_RETURN) succ[0] = loop.entry;
+            for (size_t j = 0; j < k; j++) {
+                if (pass == 0) predStart[succ[j] + 1]++;
+                else preds[predStart[succ[j]]++] = id;
+            }
+        }
+        if (pass == 0) {
+            for (size_t i = 0; i < n; i++) predStart[i + 1] += predStart[i];
+            preds.resize(predStart[n]);
+        } else {
+            // O segundo passo avançou cada início até o fim do seu trecho
+            for (size_t i = n; i > 0; i--) predStart[i] = predStart[i - 1];
+            predStart[0] = 0;
+        }
+    }
+
+    first.resize(n);
+    size_t commands = 0;
+    for (BasicBlockId id = 0; id < n; id++) {
+        first[id] = (uint32_t)commands;
+        commands += loop.blocks[id].size();
+    }
+    flags.assign(commands, 0);
+
+    // Ponto fixo com lista de trabalho: começa pelos últimos blocos, e um
+    // bloco volta para a lista quando a entrada de um sucessor cresce. A
+    // última visita de cada bloco já viu as entradas finais dos sucessores
+    // (senão ele teria voltado para a lista), então as marcas que ficam
+    // são as do ponto fixo
+    live.liveIn.assign(n * live.words, 0);
+    std::vector<BasicBlockId> work;
+    std::vector<uint8_t> queued(n, 1);
+    work.reserve(n);
+    for (BasicBlockId id = 0; id < n; id++) work.push_back(id);
+    while (!work.empty()) {
+        BasicBlockId id = work.back();
+        work.pop_back();
+        queued[id] = 0;
+
+        live.liveOut(id);
+        live.transfer(loop.blocks[id], flags.data() + first[id]);
+        uint64_t* in = &live.liveIn[id * live.words];
+        bool changed = false;
+        for (size_t w = 0; w < live.words; w++) {
+            if (in[w] != live.live[w]) {
+                in[w] = live.live[w];
+                changed = true;
+            }
+        }
+        if (!changed) continue;
+        for (uint32_t p = predStart[id]; p < predStart[id + 1]; p++) {
+            if (!queued[preds[p]]) {
+                queued[preds[p]] = 1;
+                work.push_back(preds[p]);
+            }
+        }
+    }
+
+    for (uint8_t f : flags) count += f;
+    TRACE(TRACE_CODEGEN, TRACE_INFO, "Vivacidade: %u variaveis escritas em repita, %zu atribuicoes mortas",
+          live.variables, count);
+    if (count == 0) {
+        first.clear();
+        flags.clear();
+    }
+}
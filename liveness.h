@@ -0,0 +1,50 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "ast.h"
+#include "cfg.h"
+
+/**
+ * @brief Atribuições mortas de repita: o valor escrito nunca é lido
+ *        depois (nem por ajustarPWM, esperar, comandos de pino, WiFi,
+ *        condições ou outra atribuição que esteja viva), nem na volta
+ *        seguinte de loop().
+ *
+ * Análise de vivacidade para trás no grafo de repita, com a aresta de
+ * volta do fim de loop() para o começo, até o ponto fixo. Uma variável só
+ * é usada pelo lado direito de uma atribuição se essa atribuição estiver
+ * viva, então cadeias inteiras somem (ex.: `x = x + 1;` sem outro leitor).
+ * Só as variáveis escritas em repita entram nos conjuntos (um bit cada).
+ *
+ * Leituras de pino (lerDigital/lerAnalogico) não são omitidas: a chamada
+ * continua, mesmo que o valor não sirva.
+ */
+class DeadStores {
+public:
+    DeadStores() : count(0) {}
+
+    /**
+     * @brief Analisa o grafo de repita (esquece o resultado anterior).
+     */
+    void run(const ControlFlowGraph& loop);
+
+    /**
+     * @brief true se o comando `index` do bloco `block` é uma atribuição
+     *        que pode ser omitida.
+     */
+    bool dead(BasicBlockId block, size_t index) const {
+        return !flags.empty() && flags[first[block] + index];
+    }
+
+    size_t size() const { return count; }  // atribuições mortas
+
+private:
+    std::vector<uint32_t> first;  // posição do primeiro comando de cada bloco em `flags`
+    std::vector<uint8_t> flags;
+    size_t count;
+};
+
+#endif // LIVENESS_H
@@ -0,0 +1,399 @@
+/* ------------------------------------------------------------------
+   Linha de comando do compilador. Toda a compilação fica na biblioteca
+   (compiler.h); aqui só tratamos opções, arquivos e mensagens.
+   ------------------------------------------------------------------ */
+#include "compiler.h"
+#include "ledc.h"
+#include "trace.h"
+#include "lexbench.h"
+#include "parsebench.h"
+#include "memstats.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::vector;
+using std::string;
+
+static void usage(const char* prog) {
+    std::cerr << "Uso: " << prog << " [-v|-vv] [--trace=lex,parse,semantic,codegen] [--trace-ring]\n"
+              << "       [--lexer=flex|simd] [--lex-threads=N] [--lexer-check] [--lexer-bench[=N]]\n"
+              << "       [--parser=bison|rd] [--parser-check] [--parser-bench[=N]]\n"
+              << "       [--alloc-stats] [--dump-cfg] [--max-errors=N] [--stream]\n"
+              << "       [--no-pin-flow] [--no-const-fold] [--no-dead-stores]\n"
+              << "       [--no-pwm-ranges] [--no-hoist] [--no-narrow-types]\n"
+              << "       [--non-blocking-wait] [-o saida.cpp] [entrada.txt ...]\n"
+              << "Sem entradas, lê da entrada padrão. Com várias entradas, cada uma\n"
+              << "gera o .cpp de mesmo nome (ex.: prog.txt -> prog.cpp).\n";
+}
+
+/**
+ * @brief Nome do .cpp gerado para `input` quando há várias entradas.
+ */
+static string outputNameFor(const string& input) {
+    size_t slash = input.find_last_of('/');
+    size_t dot = input.find_last_of('.');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return input + ".cpp";
+    }
+    return input.substr(0, dot) + ".cpp";
+}
+
+// Tamanho de cada leitura no modo --stream
+static const size_t STREAM_CHUNK = 64 * 1024;
+
+/**
+ * @brief Imprime os diagnósticos a partir de `from` como o compilador
+ *        sempre fez: erros de sintaxe em stdout, léxicos e semânticos em
+ *        stderr.
+ */
+static void printDiagnostics(const DiagnosticList& diagnostics, size_t from = 0) {
+    for (size_t i = from; i < diagnostics.size(); i++) {
+        const Diagnostic& d = diagnostics[i];
+        std::ostream& out = d.kind == DIAG_SINTATICO ? cout : std::cerr;
+        out << d.message << "\n";
+    }
+}
+
+/**
+ * @brief Mostra os diagnósticos e o resumo de uma compilação.
+ * @param printed Diagnósticos já impressos (modo --stream).
+ * @return result.ok (false se houve erro).
+ */
+static bool reportResult(const CompileResult& result, const string& name, size_t printed) {
+    cout << result.cfgText;
+    printDiagnostics(result.diagnostics, printed);
+    if (result.diagnostics.droppedCount() > 0) {
+        std::cerr << "... outros erros omitidos (limite de " << result.diagnostics.size()
+                  << ", veja --max-errors)\n";
+    }
+    if (!result.ok) {
+        return false;
+    }
+    printDiagnostics(result.warnings);
+    cout << "Análise semântica concluída sem erros!\n";
+
+    cout << "\n========== Resumo do AST (" << name << ") ==========\n";
+    cout << "Declaracoes de variaveis: " << result.declarations << "\n";
+    cout << "Comandos em config:       " << result.configCommands << "\n";
+    cout << "Comandos em repita:       " << result.repitaCommands << "\n";
+    cout << "RAM economizada:          " << result.ramSaved << " bytes (tipos estreitos)\n";
+    cout << "PWM (LEDC):               " << result.pwmChannels << " canais, "
+         << result.pwmTimers << " de " << LEDC_TIMERS << " temporizadores\n";
+    return true;
+}
+
+/**
+ * @brief Mostra o resultado de uma compilação e grava `outputFile`.
+ * @return false se houve erro (nada é gravado).
+ */
+static bool writeResult(const CompileResult& result, const string& name, const string& outputFile) {
+    if (!reportResult(result, name, 0)) {
+        return false;
+    }
+
+    std::ofstream file(outputFile.c_str());
+    if (!file) {
+        std::cerr << "Erro ao criar arquivo " << outputFile << "\n";
+        return false;
+    }
+    file << result.code;
+    cout << "Código C++ gerado em " << outputFile << "\n";
+    return true;
+}
+
+/**
+ * @brief Compila uma entrada já carregada e grava `outputFile`.
+ *        O mesmo Compiler é reaproveitado entre as entradas.
+ */
+static bool compileSource(Compiler& compiler, SourceBuffer& source, const string& outputFile,
+                          const CompileOptions& options) {
+    CompileResult result = compiler.compile(source, options);
+    return writeResult(result, source.name, outputFile);
+}
+
+/**
+ * @brief --stream: lê `fd` aos pedaços e compila enquanto lê; cada
+ *        diagnóstico é impresso assim que aparece, e o código gerado vai
+ *        para o disco sem ficar inteiro em memória.
+ * @return false se houve erro (de leitura ou de compilação).
+ */
+static bool streamSource(StreamCompiler& stream, int fd, const string& name,
+                         const string& outputFile) {
+    vector<char> chunk(STREAM_CHUNK);
+    size_t printed = 0;
+    for (;;) {
+        ssize_t n = read(fd, chunk.data(), chunk.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            std::cerr << "Erro ao ler arquivo " << name << "\n";
+            return false;
+        }
+        if (n == 0) break;
+        stream.feed(chunk.data(), (size_t)n);
+        if (stream.diagnostics().size() > printed) {
+            printDiagnostics(stream.diagnostics(), printed);
+            printed = stream.diagnostics().size();
+            cout.flush();
+        }
+    }
+
+    // O código vai direto para um arquivo temporário ao lado da saída (sem
+    // passar pela memória) e só a substitui se a compilação der certo
+    string partial = outputFile + ".parcial";
+    std::ofstream file(partial.c_str());
+    if (!file) {
+        std::cerr << "Erro ao criar arquivo " << partial << "\n";
+        return false;
+    }
+    CompileResult result = stream.finish(file);
+    file.close();
+    if (!reportResult(result, name, printed)) {
+        unlink(partial.c_str());
+        return false;
+    }
+    if (!file || rename(partial.c_str(), outputFile.c_str()) != 0) {
+        std::cerr << "Erro ao criar arquivo " << outputFile << "\n";
+        unlink(partial.c_str());
+        return false;
+    }
+    cout << "Código C++ gerado em " << outputFile << "\n";
+    return true;
+}
+
+/**
+ * @brief Relatório de --alloc-stats para uma compilação.
+ */
+static void printAllocStats(const string& name, const ASTProgram& program) {
+    AllocStats heap = allocStatsGet();
+    const Arena& arena = program.arena;
+    cout << "\n========== Alocações (" << name << ") ==========\n";
+    cout << "Heap:  " << heap.calls << " alocações, " << heap.bytes / 1024 << " KiB pedidos, "
+         << "pico de " << heap.peakBytes / 1024 << " KiB\n";
+    cout << "Arena: " << arena.bytesUsed() / 1024 << " KiB usados (pico "
+         << arena.peakBytes() / 1024 << " KiB) em " << arena.chunkCount() << " bloco(s), "
+         << arena.bytesReserved() / 1024 << " KiB reservados\n";
+    cout << "Nomes: " << program.textArena.bytesUsed() / 1024 << " KiB de texto internado ("
+         << program.names.size() << " nomes, " << program.literals.size() << " literais)\n";
+}
+
+/* Função principal */
+int main(int argc, char** argv) {
+    // Opções de trace: desligado por padrão (sem custo de I/O)
+    int traceLevel = TRACE_OFF;
+    unsigned traceMask = TRACE_ALL;
+    TraceSinkMode traceMode = TRACE_SINK_STREAM;
+
+    vector<string> inputs;
+    string outputFile;
+
+    // Léxico/parser e modos de verificação/benchmark do front end
+    FrontendOptions frontend;
+    bool checkLexer = false;
+    int benchRounds = 0;
+    bool checkParser = false;
+    int parserBenchRounds = 0;
+    bool allocStats = false;
+    bool dumpCfg = false;
+    size_t maxErrors = CompileOptions().maxDiagnostics;
+    bool stream = false;
+    bool pinFlow = true;
+    bool constFold = true;
+    bool deadStores = true;
+    bool pwmRanges = true;
+    bool hoist = true;
+    bool narrowTypes = true;
+    bool nonBlockingWait = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-v") == 0) {
+            traceLevel = TRACE_INFO;
+        } else if (strcmp(argv[i], "-vv") == 0) {
+            traceLevel = TRACE_DEBUG;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0) {
+            traceMask = traceParseCategories(argv[i] + 8);
+            if (traceMask == 0) {
+                std::cerr << "Categoria de trace desconhecida: " << (argv[i] + 8) << "\n";
+                usage(argv[0]);
+                return 1;
+            }
+            if (traceLevel == TRACE_OFF) traceLevel = TRACE_INFO;
+        } else if (strcmp(argv[i], "--trace-ring") == 0) {
+            traceMode = TRACE_SINK_RING;
+        } else if (strcmp(argv[i], "--lexer=flex") == 0) {
+            frontend.lexer = LEXER_FLEX;
+        } else if (strcmp(argv[i], "--lexer=simd") == 0) {
+            frontend.lexer = LEXER_SIMD;
+        } else if (strncmp(argv[i], "--lex-threads=", 14) == 0) {
+            int n = atoi(argv[i] + 14);
+            if (n <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            frontend.lexThreads = (unsigned)n;
+        } else if (strcmp(argv[i], "--parser=bison") == 0) {
+            frontend.parser = PARSER_BISON;
+        } else if (strcmp(argv[i], "--parser=rd") == 0) {
+            frontend.parser = PARSER_RD;
+        } else if (strcmp(argv[i], "--parser-check") == 0) {
+            checkParser = true;
+        } else if (strncmp(argv[i], "--parser-bench", 14) == 0
+                   && (argv[i][14] == '\0' || argv[i][14] == '=')) {
+            parserBenchRounds = argv[i][14] == '=' ? atoi(argv[i] + 15) : 5;
+            if (parserBenchRounds <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--lexer-check") == 0) {
+            checkLexer = true;
+        } else if (strncmp(argv[i], "--lexer-bench", 13) == 0
+                   && (argv[i][13] == '\0' || argv[i][13] == '=')) {
+            benchRounds = argv[i][13] == '=' ? atoi(argv[i] + 14) : 5;
+            if (benchRounds <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--alloc-stats") == 0) {
+            allocStats = true;
+        } else if (strcmp(argv[i], "--dump-cfg") == 0) {
+            dumpCfg = true;
+        } else if (strncmp(argv[i], "--max-errors=", 13) == 0) {
+            int n = atoi(argv[i] + 13);
+            if (n < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+            maxErrors = (size_t)n;  // 0 = sem limite
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = true;
+        } else if (strcmp(argv[i], "--no-pin-flow") == 0) {
+            pinFlow = false;
+        } else if (strcmp(argv[i], "--no-const-fold") == 0) {
+            constFold = false;
+        } else if (strcmp(argv[i], "--no-dead-stores") == 0) {
+            deadStores = false;
+        } else if (strcmp(argv[i], "--no-pwm-ranges") == 0) {
+            pwmRanges = false;
+        } else if (strcmp(argv[i], "--no-hoist") == 0) {
+            hoist = false;
+        } else if (strcmp(argv[i], "--no-narrow-types") == 0) {
+            narrowTypes = false;
+        } else if (strcmp(argv[i], "--non-blocking-wait") == 0) {
+            nonBlockingWait = true;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.size() > 1 && !outputFile.empty()) {
+        std::cerr << "Erro: -o só pode ser usado com uma única entrada.\n";
+        return 1;
+    }
+    traceSetup(traceLevel, traceMask, traceMode, stderr);
+
+    // Sem arquivos (ou "-"): lê a entrada padrão, como antes
+    if (inputs.empty()) {
+        inputs.push_back("-");
+    }
+
+    // Um único compilador (AST e arena) para todas as entradas
+    Compiler compiler;
+    CompileOptions options;
+    options.frontend = frontend;
+    options.dumpCfg = dumpCfg;
+    options.maxDiagnostics = maxErrors;
+    options.pinFlow = pinFlow;
+    options.constFold = constFold;
+    options.deadStores = deadStores;
+    options.pwmRanges = pwmRanges;
+    options.hoist = hoist;
+    options.narrowTypes = narrowTypes;
+    options.nonBlockingWait = nonBlockingWait;
+    int status = 0;
+    const bool frontendOnly = checkLexer || benchRounds > 0 || checkParser || parserBenchRounds > 0;
+
+    for (const string& input : inputs) {
+        string out = outputFile;
+        if (out.empty()) {
+            out = inputs.size() > 1 ? outputNameFor(input) : "output.cpp";
+        }
+        if (!frontendOnly && out == input) {
+            std::cerr << "Erro: a saída sobrescreveria a entrada " << input << "\n";
+            return 1;
+        }
+
+        // --stream: compila enquanto lê, sem esperar a entrada inteira
+        if (stream && !frontendOnly) {
+            int fd = input == "-" ? 0 : open(input.c_str(), O_RDONLY);
+            if (fd < 0) {
+                std::cerr << "Erro ao ler arquivo " << input << "\n";
+                return 1;
+            }
+            string name = input == "-" ? "<stdin>" : input;
+            if (allocStats) {
+                allocStatsReset();
+            }
+            StreamCompiler streamer(options, name);
+            if (!streamSource(streamer, fd, name, out)) {
+                status = 1;
+            }
+            if (fd != 0) close(fd);
+            if (allocStats) {
+                printAllocStats(name, streamer.program());
+            }
+            continue;
+        }
+
+        SourceBuffer source;
+        bool loaded = input == "-" ? source.loadStream(stdin, "<stdin>")
+                                   : source.load(input);
+        if (!loaded) {
+            std::cerr << "Erro ao ler arquivo " << input << "\n";
+            return 1;
+        }
+
+        // Modos que só exercitam o front end (não geram código)
+        if (frontendOnly) {
+            if (checkLexer && !lexerCheck(source, frontend.lexThreads)) {
+                return 1;
+            }
+            if (benchRounds > 0) {
+                lexerBenchmark(source, benchRounds, frontend.lexThreads);
+            }
+            if (checkParser && !parserCheck(source, frontend)) {
+                return 1;
+            }
+            if (parserBenchRounds > 0) {
+                parserBenchmark(source, parserBenchRounds, frontend);
+            }
+            continue;
+        }
+
+        if (allocStats) {
+            allocStatsReset();
+        }
+        if (!compileSource(compiler, source, out, options)) {
+            status = 1;  // segue com as próximas entradas
+        }
+        if (allocStats) {
+            printAllocStats(source.name, compiler.program());
+        }
+    }
+
+    traceFlush();
+    return status;
+}
+
+
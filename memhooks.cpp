@@ -0,0 +1,33 @@
+#include "memstats.h"
+#include <new>
+
+/* -------------------------------------------------
+ * operator new/delete do programa inteiro
+ *
+ * Fica fora da biblioteca (libesp32dsl.a): só o executável conta as
+ * alocações; quem embute o compilador mantém o próprio operator new.
+ * ------------------------------------------------- */
+void* operator new(size_t size) {
+    void* p = countedMalloc(size == 0 ? 1 : size);
+    if (p == NULL) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedMalloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedMalloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
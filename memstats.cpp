@@ -0,0 +1,80 @@
+#include "memstats.h"
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+/*
+ * Cada bloco guarda o próprio tamanho num cabeçalho, para que a
+ * liberação desconte os bytes vivos sem depender do sized delete.
+ * Os contadores são atômicos: o léxico paralelo aloca em várias threads.
+ */
+static const size_t HEADER = alignof(max_align_t);
+
+static std::atomic<size_t> allocCalls(0);
+static std::atomic<size_t> allocBytes(0);
+static std::atomic<size_t> liveBytes(0);
+static std::atomic<size_t> peakBytes(0);
+
+static void notePeak(size_t live) {
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak
+           && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* countedMalloc(size_t size) {
+    char* block = (char*)malloc(size + HEADER);
+    if (block == NULL) {
+        return NULL;
+    }
+    *(size_t*)block = size;
+    allocCalls.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    notePeak(liveBytes.fetch_add(size, std::memory_order_relaxed) + size);
+    return block + HEADER;
+}
+
+void countedFree(void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    char* block = (char*)ptr - HEADER;
+    liveBytes.fetch_sub(*(size_t*)block, std::memory_order_relaxed);
+    free(block);
+}
+
+void* countedRealloc(void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return countedMalloc(size);
+    }
+    char* block = (char*)ptr - HEADER;
+    size_t old = *(size_t*)block;
+    block = (char*)realloc(block, size + HEADER);
+    if (block == NULL) {
+        return NULL;
+    }
+    *(size_t*)block = size;
+    allocCalls.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size >= old) {
+        notePeak(liveBytes.fetch_add(size - old, std::memory_order_relaxed) + size - old);
+    } else {
+        liveBytes.fetch_sub(old - size, std::memory_order_relaxed);
+    }
+    return block + HEADER;
+}
+
+void allocStatsReset() {
+    allocCalls.store(0, std::memory_order_relaxed);
+    allocBytes.store(0, std::memory_order_relaxed);
+    peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+AllocStats allocStatsGet() {
+    AllocStats s;
+    s.calls = allocCalls.load(std::memory_order_relaxed);
+    s.bytes = allocBytes.load(std::memory_order_relaxed);
+    s.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    s.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,33 @@
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <stddef.h>
+
+/**
+ * @brief Contadores de alocação no heap (operator new/delete do programa
+ *        e buffers do flex). Servem para medir o tráfego de malloc de
+ *        uma compilação (--alloc-stats). O operator new contado está em
+ *        memhooks.cpp, que só entra no executável.
+ */
+struct AllocStats {
+    size_t calls;      // alocações (new / malloc) desde o último reset
+    size_t bytes;      // bytes pedidos nessas alocações
+    size_t liveBytes;  // bytes ainda não liberados
+    size_t peakBytes;  // maior liveBytes desde o último reset
+};
+
+/**
+ * @brief Zera as contagens; o pico recomeça dos bytes vivos atuais.
+ */
+void allocStatsReset();
+
+AllocStats allocStatsGet();
+
+/**
+ * @brief malloc/realloc/free contados (usados pelo yyalloc do flex).
+ */
+void* countedMalloc(size_t size);
+void* countedRealloc(void* ptr, size_t size);
+void countedFree(void* ptr);
+
+#endif // MEMSTATS_H
@@ -2,24 +2,22 @@
 #include <WiFi.h>
 
 // ========== Variáveis Globais ==========
-int ledPin;
-int brilho;
-bool botao;
+constexpr uint8_t ledPin = 2;
+uint8_t brilho;
+constexpr bool botao = 1;
 bool estadoBotao;
 String ssid;
 String senha;
 
-const int canal_ledPin = 0;
+const int canal_ledPin = 0;  // temporizador 0
 const int freq_ledPin  = 5000;
 const int resol_ledPin = 8;
 
 
 void setup() {
-  ledPin = 2;
   pinMode(ledPin, OUTPUT);
-  botao = 4;
   pinMode(botao, INPUT);
-  brilho = (100+((20*2)));
+  brilho = 140;
   ssid = "MinhaRedeWiFi";
   senha = "SenhaSegura";
   ledcSetup(canal_ledPin, freq_ledPin, resol_ledPin);
@@ -0,0 +1,111 @@
+#include "parlexer.h"
+#include "simdlexer.h"
+#include "parser.tab.h"
+#include <string.h>
+#include <thread>
+
+// Fatias menores que isso não compensam uma thread
+static const size_t MIN_SLICE = 256 * 1024;
+
+// Estimativa para reservar os vetores de tokens de uma vez
+static const size_t BYTES_PER_TOKEN = 4;
+
+/**
+ * @brief Resultado da varredura de uma fatia.
+ */
+struct Slice {
+    const char* begin;
+    const char* end;
+    std::vector<Token> tokens;  // sem o token final
+    int lines;                  // quebras de linha da fatia
+    bool openQuote;             // terminou com uma aspa sem fechamento?
+};
+
+/**
+ * @brief Varre a fatia com um SimdLexer (linhas relativas, a partir de 1).
+ */
+static void lexSlice(Slice& slice) {
+    SimdLexer lexer(slice.begin, slice.end, 1);
+    slice.tokens.clear();
+    slice.tokens.reserve((slice.end - slice.begin) / BYTES_PER_TOKEN);
+    slice.openQuote = false;
+    Token tok;
+    for (lexer.next(tok); tok.kind != 0; lexer.next(tok)) {
+        if (tok.kind == ERRO && tok.text[0] == '"') {
+            slice.openQuote = true;
+        }
+        slice.tokens.push_back(tok);
+    }
+    slice.lines = lexer.currentLine() - 1;
+}
+
+void lexParallel(const char* begin, const char* end, unsigned threads,
+                 std::vector<Token>& out) {
+    size_t size = (size_t)(end - begin);
+    if (threads > size / MIN_SLICE) threads = (unsigned)(size / MIN_SLICE);
+    if (threads < 1) threads = 1;
+
+    // 1) Corta logo após o primeiro '\n' a partir de cada fração da entrada
+    std::vector<Slice> slices;
+    const char* start = begin;
+    for (unsigned i = 1; i < threads; i++) {
+        const char* p = begin + size * i / threads;
+        if (p < start) continue;
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        if (nl == NULL) break;
+        slices.push_back(Slice());
+        slices.back().begin = start;
+        slices.back().end = nl + 1;
+        start = nl + 1;
+    }
+    slices.push_back(Slice());
+    slices.back().begin = start;
+    slices.back().end = end;
+
+    // 2) Varre as fatias em paralelo (a primeira na própria thread)
+    {
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < slices.size(); i++) {
+            workers.emplace_back(lexSlice, std::ref(slices[i]));
+        }
+        lexSlice(slices[0]);
+        for (auto& w : workers) w.join();
+    }
+
+    // 3) Um corte dentro de uma string deixa a aspa de abertura sem par
+    //    na fatia anterior: junta as duas e varre de novo. Uma aspa que
+    //    realmente não fecha acaba juntando tudo até o fim, como o flex.
+    for (size_t i = 0; i + 1 < slices.size(); ) {
+        if (!slices[i].openQuote) {
+            i++;
+            continue;
+        }
+        slices[i].end = slices[i + 1].end;
+        slices.erase(slices.begin() + i + 1);
+        lexSlice(slices[i]);
+    }
+
+    // 4) Costura em ordem, corrigindo as linhas (a primeira fatia já
+    //    está com as linhas certas e vira o começo de `out`)
+    size_t total = 1;
+    for (const Slice& s : slices) total += s.tokens.size();
+    out.swap(slices[0].tokens);
+    out.reserve(total);
+
+    int lineOffset = slices[0].lines;
+    for (size_t i = 1; i < slices.size(); i++) {
+        for (const Token& t : slices[i].tokens) {
+            out.push_back(t);
+            out.back().line += lineOffset;
+        }
+        lineOffset += slices[i].lines;
+    }
+
+    Token eof;
+    eof.kind = 0;
+    eof.line = lineOffset + 1;
+    eof.text = end;
+    eof.length = 0;
+    eof.intval = 0;
+    out.push_back(eof);
+}
@@ -0,0 +1,28 @@
+#ifndef PARLEXER_H
+#define PARLEXER_H
+
+#include <stddef.h>
+#include <vector>
+#include "lextoken.h"
+
+/**
+ * @brief Análise léxica paralela de uma entrada grande.
+ *
+ * A entrada é dividida em fatias que começam logo após uma quebra de
+ * linha. Cada fatia é varrida pelo SimdLexer em uma thread, e os
+ * vetores de tokens são concatenados em ordem, com as linhas ajustadas
+ * pelo número de quebras de linha das fatias anteriores.
+ *
+ * Só strings "..." atravessam linhas, então um corte só é inválido se
+ * cair dentro de uma; nesse caso a fatia anterior termina com uma aspa
+ * sem fechamento, e as duas fatias são varridas de novo como uma só.
+ *
+ * O resultado é idêntico ao de varrer a entrada inteira com um único
+ * SimdLexer, inclusive o token final (kind 0), que fecha `out`.
+ *
+ * @param threads Número de threads (1 = sequencial).
+ */
+void lexParallel(const char* begin, const char* end, unsigned threads,
+                 std::vector<Token>& out);
+
+#endif // PARLEXER_H
@@ -0,0 +1,227 @@
+#include "parsebench.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief Forma textual de um AST, usada só para comparar os parsers.
+ */
+static std::string describeProgram(const ASTProgram& program) {
+    std::ostringstream out;
+    const StringInterner& names = program.names;
+    auto name = [&](SymbolId id) -> std::string {
+        return id == NO_SYMBOL ? std::string("-") : std::string(names.name(id));
+    };
+    auto literal = [&](SymbolId id) -> std::string {
+        return id == NO_SYMBOL ? std::string("-") : std::string(program.literals.name(id));
+    };
+
+    for (const VarDecl& decl : program.declarations) {
+        out << "var " << name(decl.name) << " " << decl.type << " linha=" << decl.line << "\n";
+    }
+    // config, repita e depois cada sub-bloco (os dois parsers os numeram
+    // na ordem em que são abertos)
+    size_t listCount = 2 + program.blocks.size();
+    for (size_t b = 0; b < listCount; b++) {
+        const CommandList& list = b == 0 ? program.configCommands
+                                : b == 1 ? program.repitaCommands
+                                : program.blocks[b - 2];
+        if (b < 2) out << (b == 0 ? "config\n" : "repita\n");
+        else out << "bloco " << (b - 2) << "\n";
+        for (const Command& cmd : list) {
+            out << "  " << cmd.cmdType << " linha=" << cmd.line;
+            switch (cmd.cmdType) {
+                case CMD_ASSIGN:
+                    out << " var=" << name(cmd.assign.var) << " expr=" << exprText(cmd.assign.value, program);
+                    break;
+                case CMD_LER_DIGITAL:
+                case CMD_LER_ANALOGICO:
+                    out << " var=" << name(cmd.readPin.var) << " pin=" << name(cmd.readPin.pin);
+                    break;
+                case CMD_CONFIG_PIN:
+                    out << " pin=" << name(cmd.configPin.pin) << " modo=" << pinModeName(cmd.configPin.mode);
+                    break;
+                case CMD_CONFIG_PWM:
+                    out << " pin=" << name(cmd.configPwm.pin) << " freq=" << cmd.configPwm.freq
+                        << " resol=" << cmd.configPwm.resol;
+                    break;
+                case CMD_PWM_ADJUST:
+                    out << " pin=" << name(cmd.pwmAdjust.pin) << " valor=" << exprText(cmd.pwmAdjust.value, program);
+                    break;
+                case CMD_WIFI_CONNECT:
+                    out << " ssid=" << name(cmd.wifi.ssid) << " senha=" << name(cmd.wifi.password);
+                    break;
+                case CMD_WAIT:
+                    out << " espera=" << exprText(cmd.wait.time, program);
+                    break;
+                case CMD_LIGAR:
+                case CMD_DESLIGAR:
+                    out << " digital=" << name(cmd.digital.pin);
+                    break;
+                case CMD_ENVIAR_HTTP:
+                    out << " url=" << literal(cmd.http.url) << " dados=" << literal(cmd.http.data);
+                    break;
+                case CMD_ESCREVER_SERIAL:
+                    out << " serial=" << literal(cmd.serial.msg);
+                    break;
+                case CMD_IF:
+                case CMD_WHILE:
+                    out << " cond=" << exprText(cmd.cond.condition, program)
+                        << " corpo=" << cmd.cond.body << " senao=" << (int)cmd.cond.elseBody;
+                    break;
+                default:
+                    break;
+            }
+            out << "\n";
+        }
+    }
+    return out.str();
+}
+
+static std::string describeDiagnostics(const DiagnosticList& diagnostics) {
+    std::string text;
+    for (const Diagnostic& d : diagnostics) {
+        text += std::to_string(d.kind) + " " + std::to_string(d.line) + " " + d.message + "\n";
+    }
+    return text;
+}
+
+static size_t statementCount(const ASTProgram& program) {
+    size_t count = program.declarations.size() + program.configCommands.size()
+                 + program.repitaCommands.size();
+    for (const CommandList& block : program.blocks) {
+        count += block.size();
+    }
+    return count;
+}
+
+bool parserCheck(SourceBuffer& source, const FrontendOptions& options) {
+    FrontendOptions bison = options;
+    bison.parser = PARSER_BISON;
+    FrontendOptions rd = options;
+    rd.parser = PARSER_RD;
+
+    ASTProgram expected, actual;
+    DiagnosticList expectedDiags, actualDiags;
+    int expectedResult = parseProgram(source, expected, expectedDiags, bison);
+    int actualResult = parseProgram(source, actual, actualDiags, rd);
+
+    if (expectedResult != actualResult) {
+        std::cerr << source.name << ": bison retornou " << expectedResult
+                  << ", rd retornou " << actualResult << "\n";
+        return false;
+    }
+    std::string e = describeDiagnostics(expectedDiags);
+    std::string a = describeDiagnostics(actualDiags);
+    if (e != a) {
+        std::cerr << source.name << ": erros diferentes\n--- bison\n" << e << "--- rd\n" << a;
+        return false;
+    }
+    e = describeProgram(expected);
+    a = describeProgram(actual);
+    if (e != a) {
+        std::cerr << source.name << ": ASTs diferentes\n--- bison\n" << e << "--- rd\n" << a;
+        return false;
+    }
+
+    std::cout << source.name << ": " << statementCount(expected)
+              << " declarações/comandos idênticos (bison x rd)\n";
+    return true;
+}
+
+/**
+ * @brief Resultado de uma medição, enviado do processo filho pelo pipe.
+ */
+struct ParserSample {
+    double seconds;
+    size_t statements;
+    long rssBeforeKb;   // max RSS antes de analisar
+    long rssAfterKb;    // max RSS depois das análises
+    bool ok;
+};
+
+static long maxRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static ParserSample runParser(SourceBuffer& source, int rounds, const FrontendOptions& options) {
+    typedef std::chrono::steady_clock Clock;
+    ParserSample sample = ParserSample();
+    sample.rssBeforeKb = maxRssKb();
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+        ASTProgram program;
+        DiagnosticList diagnostics;
+        parseProgram(source, program, diagnostics, options);
+        sample.statements = statementCount(program);
+    }
+    sample.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    sample.rssAfterKb = maxRssKb();
+    sample.ok = true;
+    return sample;
+}
+
+/**
+ * @brief Roda runParser() em um processo filho e lê o resultado.
+ */
+static ParserSample measureInChild(SourceBuffer& source, int rounds, const FrontendOptions& options) {
+    ParserSample sample = ParserSample();
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return sample;
+    }
+
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        ParserSample s = runParser(source, rounds, options);
+        std::cout.flush();
+        ssize_t written = write(fds[1], &s, sizeof(s));
+        _exit(written == (ssize_t)sizeof(s) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &sample, sizeof(sample)) != (ssize_t)sizeof(sample)) {
+            sample.ok = false;
+        }
+        waitpid(pid, NULL, 0);
+    }
+    close(fds[0]);
+    return sample;
+}
+
+void parserBenchmark(SourceBuffer& source, int rounds, const FrontendOptions& options) {
+    const char* names[2] = { "bison", "rd" };
+    ParserBackend backends[2] = { PARSER_BISON, PARSER_RD };
+    ParserSample samples[2];
+
+    for (int b = 0; b < 2; b++) {
+        FrontendOptions opts = options;
+        opts.parser = backends[b];
+        samples[b] = measureInChild(source, rounds, opts);
+    }
+
+    std::cout << source.name << ": " << source.size << " bytes, " << rounds << " rodada(s)\n";
+    for (int b = 0; b < 2; b++) {
+        const ParserSample& s = samples[b];
+        if (!s.ok) {
+            std::cout << "  " << names[b] << ": falhou\n";
+            continue;
+        }
+        std::cout << "  " << names[b] << ": " << s.statements << " declarações/comandos, "
+                  << (size_t)(s.statements * rounds / s.seconds) << " comandos/s, "
+                  << "pico de memória +" << (s.rssAfterKb - s.rssBeforeKb) << " KiB\n";
+    }
+    if (samples[0].ok && samples[1].ok) {
+        std::cout << "  aceleração rd: " << samples[0].seconds / samples[1].seconds << "x\n";
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef PARSEBENCH_H
+#define PARSEBENCH_H
+
+#include "frontend.h"
+
+/**
+ * @brief Analisa `source` com o parser do Bison e com o descendente
+ *        recursivo e compara os dois ASTs (declarações e comandos, campo
+ *        a campo), os códigos de retorno e os erros registrados.
+ * @return true se forem idênticos.
+ */
+bool parserCheck(SourceBuffer& source, const FrontendOptions& options);
+
+/**
+ * @brief Mede comandos/segundo e o pico de memória (max RSS) dos dois
+ *        parsers, `rounds` análises cada. Cada parser roda em um processo
+ *        filho, para que o pico de um não esconda o do outro.
+ */
+void parserBenchmark(SourceBuffer& source, int rounds, const FrontendOptions& options);
+
+#endif // PARSEBENCH_H
@@ -2,58 +2,93 @@
   #include <string>
   #include <vector>
   #include "ast.h"   // Pois VarType está definido em "ast.h"
+  #include "frontend.h"
+
+  // Tipo opaco do scanner reentrante (o flex declara o mesmo typedef)
+  #ifndef YY_TYPEDEF_YY_SCANNER_T
+  #define YY_TYPEDEF_YY_SCANNER_T
+  typedef void* yyscan_t;
+  #endif
 }
 
 %{
   #include "ast.h"   // Para ASTProgram e etc. no corpo do parser
-  #include "semantic.h"
-  #include "codegen.h"
+  #include "trace.h"
+  #include "parlexer.h"
+  #include "rdparser.h"
   #include <stdio.h>
   #include <stdlib.h>
   #include <string.h>
-  #include <iostream>
-
 
 // Para simplificar o uso de std::vector e std::string no %union
-using std::cout;
 using std::vector;
 using std::string;
 
-//Objeto global
-ASTProgram astProgram;
-
-/* 
- * Variável global para sabermos em qual bloco estamos
- * 0 = nenhum, 1 = config, 2 = repita
- */
-static int currentBlock = 0;
-
-// Declaração da função do analisador léxico
-int yylex(void);
-int yyparse(void);
-void yyerror(const char *s);
-
 // Função de validação de string
 int valid_string(const char* str);
 %}
 
+/* ------------------------------------------------------------------
+   Parser puro (reentrante): sem yylval/astProgram globais. O
+   ParseContext (AST + léxico em uso) é passado como parâmetro.
+   ------------------------------------------------------------------ */
+%define api.pure full
+%lex-param   {ParseContext* ctx}
+%parse-param {ParseContext* ctx}
+
+/* Também gera a interface push (yypush_parse): o StreamParser entrega
+   os tokens à medida que o fonte chega, e yyparse() continua puxando
+   do léxico como antes */
+%define api.push-pull both
+
+/* Linha de cada token (@n.first_line): os comandos guardam a do seu
+   primeiro token, para os diagnósticos da semântica */
+%locations
+
+%code {
+  #include "lexer.h"
+
+  static int yylex(YYSTYPE* lval, YYLTYPE* lloc, ParseContext* ctx);
+
+  // O Bison passa a posição do erro; a mensagem usa o último token lido
+  static void yyerror(YYLTYPE*, ParseContext* ctx, const char* s) { yyerror(ctx, s); }
+
+  /* Constrói o comando direto no bloco atual (config, repita ou sub-bloco).
+     Um comando de nível superior vai antes para o listener, que pode
+     consumi-lo (geração em streaming) em vez de guardá-lo no AST */
+  template <class Payload>
+  static void addCommand(ParseContext* ctx, CmdType type, const Payload& payload, int line) {
+      CommandList* list = ctx->currentList();
+      if (!list) return;
+      if (ctx->listener && ctx->openBlocks.empty() &&
+          ctx->listener->statement(Command(type, payload, line), ctx->currentBlock == 2)) {
+          return;
+      }
+      list->emplace_back(type, payload, line);
+  }
+}
+
 /* ------------------------------------------------------------------
    União para os valores dos tokens e não-terminais
    ------------------------------------------------------------------ */
 %union {
     int intval;                /* Para tokens NUMERO, LIGAR, DESLIGAR etc. */
-    char* str;                 /* Para tokens IDENTIFICADOR, STRING_LIT etc. */
     VarType varType;           /* Para armazenar o tipo de variável (VAR_INTEIRO, etc.) */
-    std::vector<std::string>* strList; /* Para listas de identificadores */
+    SymbolId sym;              /* IDENTIFICADOR (em names); STRING_LIT e DIRECAO (em literals) */
+    ArenaVector<SymbolId>* symList; /* Para listas de identificadores (na arena) */
+    Expr* expr;                /* Para expressões (nós pertencem ao ASTProgram) */
+    BlockId block;             /* Para sub-blocos de se/senão/enquanto */
+    BlockId openedBlock;       /* Sub-bloco aberto e ainda não fechado (nested_block) */
 }
 
 /* ------------------------------------------------------------------
    Declaração dos tokens
    ------------------------------------------------------------------ */
-%token <str> IDENTIFICADOR STRING_LIT
+%token <sym> IDENTIFICADOR
+%token <sym> STRING_LIT
 %token <intval> NUMERO
 %token <intval> LIGAR DESLIGAR
-%token <str> DIRECAO
+%token <sym> DIRECAO
 
 /* Declaração dos tokens – devem corresponder aos definidos no Flex e no cabeçalho tokens.h */
 %token VAR TIPO_INTEIRO TIPO_TEXTO TIPO_BOOLEANO
@@ -89,16 +124,21 @@ int valid_string(const char* str);
    Definições de tipo de cada não-terminal
    ------------------------------------------------------------------ */
 %type <varType> type
-%type <strList> identifier_list
-%type <str> expression
-%type <str> read_digital
-%type <str> read_analog
+%type <symList> identifier_list
+%type <expr> expression
+%type <sym> read_digital
+%type <sym> read_analog
+%type <block> nested_block opt_else
+
+/* Sub-bloco descartado na recuperação de erro: fecha para que os
+   comandos seguintes voltem ao bloco de fora */
+%destructor { ctx->closeBlock(); } <openedBlock>
 
 %%
 
 /* Regra inicial do programa */
 program:
-    declaration_list configBlock repitaBlock { printf("Programa validado corretamente.\n"); }
+    declaration_list configBlock repitaBlock { TRACE(TRACE_PARSE, TRACE_INFO, "Programa validado corretamente."); }
     | program '\n'
     ;
 
@@ -112,46 +152,50 @@ declaration:
       VAR type DOIS_PONTOS identifier_list PONTO_VIRGULA 
       { 
         // $2 é <varType>, $4 é <strList>
-        // Inserir as variáveis em astProgram.declarations
-        for (auto &nome : *($4)) {
+        // Inserir as variáveis em ctx->program->declarations
+        for (SymbolId nome : *($4)) {
             VarDecl decl;
             decl.name = nome;       // ex.: "ledPin"
             decl.type = $2;        // ex.: VAR_INTEIRO
-            // isPin, isPWM, etc. começam em false (construtor default)
-            astProgram.declarations.push_back(decl);
+            decl.line = @1.first_line;
+            // pinMode, isPWM, etc. começam vazios (construtor default)
+            ctx->program->declarations.push_back(decl);
         }
-        printf("Declaracao de variaveis realizada.\n"); 
-        // Liberar a memória da lista
-        delete $4;
-        
+        TRACE(TRACE_PARSE, TRACE_INFO, "Declaracao de variaveis realizada.");
+        // A lista fica na arena (liberada junto com o AST)
+      }
+    | VAR error PONTO_VIRGULA
+      {
+        // Declaração inválida: o erro já foi registrado; segue na próxima
+        yyerrok;
+        if (ctx->diagnostics->full()) YYABORT;
       }
     ;
 
 /* Tipos suportados */
 type:
-      TIPO_INTEIRO { $$ = VAR_INTEIRO; printf("Tipo: inteiro\n"); }
-    | TIPO_TEXTO   { $$ = VAR_TEXTO; printf("Tipo: texto\n"); }
-    | TIPO_BOOLEANO { $$ = VAR_BOOLEANO; printf("Tipo: booleano\n"); }
+      TIPO_INTEIRO { $$ = VAR_INTEIRO; TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: inteiro"); }
+    | TIPO_TEXTO   { $$ = VAR_TEXTO; TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: texto"); }
+    | TIPO_BOOLEANO { $$ = VAR_BOOLEANO; TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: booleano"); }
     ;
 
 /* Lista de identificadores: "ledPin, brilho" */
 identifier_list:
       IDENTIFICADOR 
       { 
-        // Cria uma lista e insere $1
-        auto v = new vector<string>();
+        // Cria uma lista (na arena) e insere $1
+        Arena& arena = ctx->program->arena;
+        auto v = arena.create<ArenaVector<SymbolId>>(ArenaAllocator<SymbolId>(&arena));
         v->push_back($1);
         $$ = v;
-        printf("Declarando variavel: %s\n", $1); 
-        free($1); // liberamos a string alocada pelo lexer
+        TRACE(TRACE_PARSE, TRACE_INFO, "Declarando variavel: %s", ctx->program->names.cstr($1));
       }
     | identifier_list VIRGULA IDENTIFICADOR 
     { 
       // anexa $3 na lista existente $1
       $1->push_back($3);
       $$ = $1;
-      printf("Declarando variavel: %s\n", $3); 
-      free($3);
+      TRACE(TRACE_PARSE, TRACE_INFO, "Declarando variavel: %s", ctx->program->names.cstr($3));
     }
     ;
 
@@ -159,12 +203,14 @@ identifier_list:
 configBlock:
       CONFIG
         {
-          currentBlock = 1; // Indica que estamos em "config"
+          ctx->currentBlock = 1; // Indica que estamos em "config"
+          if (ctx->listener) ctx->listener->declarationsDone();
         }
       statement_list FIM
         {
-          currentBlock = 0; // encerramos config
-          printf("Bloco de configuracao executado.\n");
+          ctx->currentBlock = 0; // encerramos config
+          TRACE(TRACE_PARSE, TRACE_INFO, "Bloco de configuracao executado.");
+          if (ctx->listener) ctx->listener->configDone();
         }
     ;
 
@@ -172,11 +218,11 @@ configBlock:
 repitaBlock:
       REPITA
         {
-          currentBlock = 2; // Indica que estamos em "repita"
+          ctx->currentBlock = 2; // Indica que estamos em "repita"
         }
       statement_list FIM
         {
-          currentBlock = 0; // encerra "repita"
+          ctx->currentBlock = 0; // encerra "repita"
           // printf("Loop principal (repita) executado.\n");
         }
     ;
@@ -191,59 +237,34 @@ statement:
       assignment_statement
     | command_statement
     | control_structure
+    | error PONTO_VIRGULA
+      {
+        // Recuperação: descarta até o próximo ';' e continua a lista de
+        // comandos, para que uma execução mostre todos os erros
+        yyerrok;
+        if (ctx->diagnostics->full()) YYABORT;
+      }
     ;
 
 /* Atribuição de valor a uma variável */
 assignment_statement:
       IDENTIFICADOR IGUAL expression PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_ASSIGN;
-        cmd.varName = $1;  // ex.: "ledPin"
-        cmd.expr = $3;     // ex.: "2", "brilho", etc.
-
-        // Adiciona no bloco atual (config ou repita)
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Atribuindo: %s = %s\n", $1, $3);
-        free($1);
-        free($3);
+        // ex.: "ledPin" = 2, brilho, etc.
+        addCommand(ctx, CMD_ASSIGN, AssignCmd{$1, $3}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Atribuindo: %s = %s", ctx->program->names.cstr($1),
+              exprText($3, *ctx->program).c_str());
       }
       | IDENTIFICADOR IGUAL read_digital PONTO_VIRGULA
       {
         // "estadoBotao = lerDigital botao;"
-        Command cmd;
-        cmd.cmdType = CMD_LER_DIGITAL;
-        cmd.varName = $1; // ex.: "estadoBotao"
-        cmd.pin     = $3; // ex.: "botao" (vem da regra read_digital)
-        // ...
-        // Inserir no configCommands ou repitaCommands dependendo de currentBlock
-        if(currentBlock == 1) 
-            astProgram.configCommands.push_back(cmd);
-        else if(currentBlock == 2)
-            astProgram.repitaCommands.push_back(cmd);
-
-        free($1);
-        free($3);
+        // $1 = "estadoBotao", $3 = "botao" (vem da regra read_digital)
+        addCommand(ctx, CMD_LER_DIGITAL, ReadPinCmd{$1, $3}, @1.first_line);
       }
       | IDENTIFICADOR IGUAL read_analog PONTO_VIRGULA
       {
         // "sensorValor = lerAnalogico sensor;"
-        Command cmd;
-        cmd.cmdType = CMD_LER_ANALOGICO;
-        cmd.varName = $1;  // ex.: "sensorValor"
-        cmd.pin     = $3;  // ex.: "sensor"
-        // ...
-        if(currentBlock == 1)
-            astProgram.configCommands.push_back(cmd);
-        else if(currentBlock == 2)
-            astProgram.repitaCommands.push_back(cmd);
-
-        free($1);
-        free($3);
+        addCommand(ctx, CMD_LER_ANALOGICO, ReadPinCmd{$1, $3}, @1.first_line);
       }
     ;
 
@@ -263,19 +284,10 @@ command_statement:
 config_command:
       CONFIGURAR IDENTIFICADOR COMO DIRECAO PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_CONFIG_PIN;
-        cmd.pin = $2;        // "ledPin"
-        cmd.pinMode = $4;    // "saida", "entrada", etc.
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Configurando pino: %s como saida.\n", $2);
-        free($2);
-        free($4);
+        // "ledPin" como "saida", "entrada", etc.
+        addCommand(ctx, CMD_CONFIG_PIN, ConfigPinCmd{$2, pinModeFromText(ctx->program->literals.name($4))}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Configurando pino: %s como %s.", ctx->program->names.cstr($2),
+              ctx->program->literals.cstr($4));
       }
     ;
 
@@ -283,19 +295,10 @@ config_command:
 pwm_config_command:
       CONFIGURAR_PWM IDENTIFICADOR COM FREQUENCIA NUMERO RESOLUCAO NUMERO PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_CONFIG_PWM;
-        cmd.pin = $2;    // ex.: "ledPin"
-        cmd.freq = $5;   // ex.: 5000
-        cmd.resol = $7;  // ex.: 8
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Configurando PWM no pino: %s com frequencia: %d e resolucao: %d\n", $2, $5, $7);
-        free($2);
+        // ex.: "ledPin", 5000, 8
+        addCommand(ctx, CMD_CONFIG_PWM, ConfigPwmCmd{$2, $5, $7}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Configurando PWM no pino: %s com frequencia: %d e resolucao: %d",
+              ctx->program->names.cstr($2), $5, $7);
       }
     ;
 
@@ -303,19 +306,10 @@ pwm_config_command:
 pwm_adjust_command:
       AJUSTAR_PWM IDENTIFICADOR COM VALOR expression PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_PWM_ADJUST;
-        cmd.pin = $2;         // "ledPin"
-        cmd.valueExpr = $5;   // "brilho", "128", etc.
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Ajustando PWM no pino: %s com valor: %s\n", $2, $5);
-        free($2);
-        free($5);
+        // "ledPin" com brilho, 128, etc.
+        addCommand(ctx, CMD_PWM_ADJUST, PwmAdjustCmd{$2, DUTY_UNCHECKED, $5}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Ajustando PWM no pino: %s com valor: %s", ctx->program->names.cstr($2),
+              exprText($5, *ctx->program).c_str());
       }
     ;
 
@@ -323,19 +317,9 @@ pwm_adjust_command:
 wifi_connect_command:
       CONECTAR_WIFI IDENTIFICADOR IDENTIFICADOR PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_WIFI_CONNECT;
-        cmd.ssid = $2;
-        cmd.password = $3;
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Conectando WiFi: SSID = %s, SENHA = %s\n", $2, $3);
-        free($2);
-        free($3);
+        addCommand(ctx, CMD_WIFI_CONNECT, WifiCmd{$2, $3}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Conectando WiFi: SSID = %s, SENHA = %s",
+              ctx->program->names.cstr($2), ctx->program->names.cstr($3));
       }
     ;
 
@@ -343,17 +327,8 @@ wifi_connect_command:
 wait_command:
       ESPERAR expression PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_WAIT;
-        cmd.waitTime = $2; // ex. "1000"
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Esperando: %s ms\n", $2);
-        free($2);
+        addCommand(ctx, CMD_WAIT, WaitCmd{$2}, @1.first_line); // ex. 1000
+        TRACE(TRACE_PARSE, TRACE_INFO, "Esperando: %s ms", exprText($2, *ctx->program).c_str());
       }
     ;
 
@@ -361,31 +336,13 @@ wait_command:
 digital_command:
       LIGAR IDENTIFICADOR PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_LIGAR;
-        cmd.digitalPin = $2;
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Comando digital: LIGAR %s\n", $2);
-        free($2);
+        addCommand(ctx, CMD_LIGAR, DigitalCmd{$2}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Comando digital: LIGAR %s", ctx->program->names.cstr($2));
       }
     | DESLIGAR IDENTIFICADOR PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_DESLIGAR;
-        cmd.digitalPin = $2;
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Comando digital: DESLIGAR %s\n", $2);
-        free($2);
+        addCommand(ctx, CMD_DESLIGAR, DigitalCmd{$2}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Comando digital: DESLIGAR %s", ctx->program->names.cstr($2));
       }
     ;
 
@@ -409,19 +366,10 @@ read_analog:
 http_command:
       ENVIAR_HTTP STRING_LIT STRING_LIT PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_ENVIAR_HTTP;
-        cmd.httpUrl = $2;   // ex.: "http://example.com"
-        cmd.httpData = $3;  // ex.: "dados=123"
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Enviando HTTP: URL = %s, DADOS = %s\n", $2, $3);
-        free($2);
-        free($3);
+        // ex.: "http://example.com", "dados=123"
+        addCommand(ctx, CMD_ENVIAR_HTTP, HttpCmd{$2, $3}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Enviando HTTP: URL = %s, DADOS = %s",
+              ctx->program->literals.cstr($2), ctx->program->literals.cstr($3));
       }
     ;
 
@@ -429,29 +377,13 @@ http_command:
 serial_command:
       ESCREVER_SERIAL STRING_LIT PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_ESCREVER_SERIAL;
-        cmd.serialMsg = $2;  // ex.: "Mensagem"
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Escrevendo na Serial: %s\n", $2);
-        free($2);
+        addCommand(ctx, CMD_ESCREVER_SERIAL, SerialCmd{$2}, @1.first_line); // ex.: "Mensagem"
+        TRACE(TRACE_PARSE, TRACE_INFO, "Escrevendo na Serial: %s", ctx->program->literals.cstr($2));
       }
     | LER_SERIAL PONTO_VIRGULA
       {
-        Command cmd;
-        cmd.cmdType = CMD_LER_SERIAL;
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Lendo da Serial\n");
+        addCommand(ctx, CMD_LER_SERIAL, SerialCmd{NO_SYMBOL}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Lendo da Serial");
       }
     ;
 
@@ -464,189 +396,281 @@ control_structure:
 /* Estrutura condicional (if) */
 /* if_statement: se expr entao statement_list [senao statement_list] fim */
 if_statement:
-      SE expression ENTAO statement_list opt_else FIM
+      SE expression ENTAO nested_block opt_else FIM
       {
-        Command cmd;
-        cmd.cmdType = CMD_IF;
-        cmd.conditionExpr = $2; // ex.: "(brilho>128)"
-        // Caso queira guardar os subcomandos do 'then' e 'else', 
-        // teria que expandir a AST para suportar sub-blocos.
-        // Aqui, simplificamos e guardamos só a expressão.
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Condicional SE executada com condicao: %s\n", $2);
-        free($2);
+        // Condição ex.: brilho > 128; os comandos do 'entao' e do
+        // 'senao' já estão nos sub-blocos $4 e $5
+        addCommand(ctx, CMD_IF, CondCmd{$2, $4, $5}, @1.first_line);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Condicional SE executada com condicao: %s",
+              exprText($2, *ctx->program).c_str());
       }
     ;
 
-/* Opcional: parte SENAO do if */
 /* Parte opcional SENAO */
 opt_else:
       /* vazio */
-    | SENAO statement_list 
-      { printf("Bloco SENAO executado.\n"); /* Em um design mais avançado, armazenaríamos os comandos do else. */ }
+      { $$ = NO_BLOCK; }
+    | SENAO nested_block
+      { $$ = $2; TRACE(TRACE_PARSE, TRACE_INFO, "Bloco SENAO executado."); }
     ;
 
 /* Estrutura de repeticao (while) */
 /* while_statement: enquanto expr statement_list fim */
 while_statement:
-      ENQUANTO expression statement_list FIM
+      ENQUANTO expression nested_block FIM
       {
-        Command cmd;
-        cmd.cmdType = CMD_WHILE;
-        cmd.conditionExpr = $2; // ex.: "(brilho<255)"
-
-        if (currentBlock == 1) {
-            astProgram.configCommands.push_back(cmd);
-        } else if (currentBlock == 2) {
-            astProgram.repitaCommands.push_back(cmd);
-        }
-        printf("Estrutura ENQUANTO executada com condicao: %s\n", $2);
-        free($2);
+        addCommand(ctx, CMD_WHILE, CondCmd{$2, $3, NO_BLOCK}, @1.first_line); // ex.: brilho < 255
+        TRACE(TRACE_PARSE, TRACE_INFO, "Estrutura ENQUANTO executada com condicao: %s",
+              exprText($2, *ctx->program).c_str());
       }
     ;
 
+/* Corpo de se/senão/enquanto: os comandos vão para um sub-bloco novo */
+nested_block:
+      <openedBlock>{ $$ = ctx->openBlock(); }
+      statement_list
+        {
+          ctx->closeBlock();
+          $$ = $1;
+        }
+    ;
+
 /* ------------------------------------------------------------------
    Definição de expressão unificada
-   (sempre retorna <str>, que é um char*)
+   (sempre retorna <expr>, um nó criado no ASTProgram)
    ------------------------------------------------------------------ */
 expression:
-      /* 1) Valor inteiro literal */
-      NUMERO 
+      NUMERO
         {
-          char buffer[32];
-          sprintf(buffer, "%d", $1);  /* $1 é <intval> */
-          $$ = strdup(buffer);        /* $$ é <str> */
+          $$ = ctx->program->newNumber($1);  /* $1 é <intval> */
         }
     | IDENTIFICADOR
         {
-          $$ = strdup($1);
-          free($1);
+          $$ = ctx->program->newIdent($1);
         }
     | STRING_LIT
         {
-          $$ = strdup($1);
-          free($1);
+          $$ = ctx->program->newString($1);  /* Mantém as aspas */
         }
     | expression MAIS expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s+%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MAIS, $1, $3);
         }
     | expression MENOS expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s-%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MENOS, $1, $3);
         }
     | expression VEZES expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s*%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_VEZES, $1, $3);
         }
     | expression DIV expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s/%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_DIV, $1, $3);
         }
     | '(' expression ')'
         {
-          int len = strlen($2) + 3;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s)", $2);
-          $$ = buf;
-          free($2);
+          $$ = ctx->program->newParen($2);
         }
     | expression MENOR expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s<%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MENOR, $1, $3);
         }
     | expression MAIOR expression
         {
-          int len = strlen($1) + strlen($3) + 5;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s>%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MAIOR, $1, $3);
         }
     | expression MENOR_IGUAL expression
         {
-          int len = strlen($1) + strlen($3) + 6;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s<=%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MENOR_IGUAL, $1, $3);
         }
     | expression MAIOR_IGUAL expression
         {
-          int len = strlen($1) + strlen($3) + 6;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s>=%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_MAIOR_IGUAL, $1, $3);
         }
     | expression IGUAL_IGUAL expression
         {
-          int len = strlen($1) + strlen($3) + 6;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s==%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_IGUAL_IGUAL, $1, $3);
         }
     | expression DIFERENTE expression
         {
-          int len = strlen($1) + strlen($3) + 6;
-          char* buf = (char*) malloc(len);
-          sprintf(buf, "(%s!=%s)", $1, $3);
-          $$ = buf;
-          free($1); free($3);
+          $$ = ctx->program->newBinary(OP_DIFERENTE, $1, $3);
         }
     ;
 
 %%
 
-void yyerror(const char *s) {
-    /* variáveis definidas no analisador léxico */
-	extern int yylineno;    
-	extern char * yytext;   
-	
+/**
+ * @brief Converte um Token do léxico manual no yylval que as ações
+ *        esperam (os mesmos valores que as regras de lexer.l produzem).
+ */
+static int tokenValue(const Token& tok, YYSTYPE* lval, ParseContext* ctx) {
+    switch (tok.kind) {
+        case IDENTIFICADOR:
+            lval->sym = ctx->program->names.intern(tok.text, tok.length);
+            break;
+        case STRING_LIT: // Mantém as aspas
+        case DIRECAO:    // "saida" / "entrada"
+            lval->sym = ctx->program->literals.intern(tok.text, tok.length);
+            break;
+        case NUMERO:
+        case LIGAR:
+        case DESLIGAR:
+            lval->intval = tok.intval;
+            break;
+        case ERRO:
+            ctx->frontendError = true;
+            ctx->diagnostics->report(DIAG_LEXICO, tok.line, "Erro: caractere inválido %.*s",
+                                     (int)tok.length, tok.text);
+            break;
+        default:
+            break;
+    }
+    TRACE(TRACE_LEX, TRACE_DEBUG, "Token: %d, Valor: %.*s", tok.kind, (int)tok.length, tok.text);
+    return tok.kind;
+}
+
+static int yylex(YYSTYPE* lval, YYLTYPE* lloc, ParseContext* ctx) {
+    int kind;
+    if (ctx->replay != NULL) {
+        ctx->lastToken = *ctx->replay;
+        if (ctx->replay + 1 < ctx->replayEnd) ctx->replay++; // o último é o fim da entrada
+        kind = tokenValue(ctx->lastToken, lval, ctx);
+    } else if (ctx->simd == NULL) {
+        kind = flexScan(lval, ctx->scanner);
+        lloc->first_line = lloc->last_line = yyget_lineno(ctx->scanner);
+        return kind;
+    } else {
+        ctx->simd->next(ctx->lastToken);
+        kind = tokenValue(ctx->lastToken, lval, ctx);
+    }
+    lloc->first_line = lloc->last_line = ctx->lastToken.line;
+    return kind;
+}
+
+void yyerror(ParseContext* ctx, const char *s) {
+    string text;
+    int line;
+    if (ctx->scanner == NULL) {  // SimdLexer, léxico paralelo ou StreamParser
+        text.assign(ctx->lastToken.text, ctx->lastToken.length);
+        line = ctx->lastToken.line;
+    } else {
+        text = yyget_text(ctx->scanner);
+        line = yyget_lineno(ctx->scanner);
+    }
 	/* mensagem de erro exibe o símbolo que causou erro e o número da linha */
-    cout << "Erro (" << s << "): símbolo \"" << yytext << "\" (linha " << yylineno << ")\n";
+    ctx->frontendError = true;
+    ctx->diagnostics->report(DIAG_SINTATICO, line, "Erro (%s): símbolo \"%s\" (linha %d)",
+                             s, text.c_str(), line);
+}
+
+int parseProgram(SourceBuffer& source, ASTProgram& program, DiagnosticList& diagnostics,
+                 const FrontendOptions& options) {
+    if (options.parser == PARSER_RD) {
+        return parseProgramRD(source, program, diagnostics, options.lexThreads);
+    }
+
+    ParseContext ctx(&program, &diagnostics);
+
+    if (options.lexThreads > 1) {
+        std::vector<Token> tokens;
+        lexParallel(source.data, source.data + source.size, options.lexThreads, tokens);
+        ctx.replay = tokens.data();
+        ctx.replayEnd = tokens.data() + tokens.size();
+        return yyparse(&ctx);
+    }
+
+    if (options.lexer == LEXER_SIMD) {
+        SimdLexer simd(source.data, source.data + source.size);
+        ctx.simd = &simd;
+        return yyparse(&ctx);
+    }
+
+    yyscan_t scanner;
+    if (yylex_init_extra(&ctx, &scanner) != 0) {
+        return 2;
+    }
+    ctx.scanner = scanner;
+    // O buffer já termina com os dois NUL exigidos pelo flex
+    YY_BUFFER_STATE buffer = yy_scan_buffer(source.data, source.size + 2, scanner);
+    int result = yyparse(&ctx);
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    return result;
 }
 
-/* Função principal */
-int main() {
-    yyparse();
-    semanticAnalysis(astProgram);
-    // Exemplo: ao final, podemos mostrar quantas declarações e comandos lemos:
-    // (ou chamaremos análise semântica e geração de código, etc.)
-    cout << "\n========== Resumo do AST ==========\n";
-    cout << "Declaracoes de variaveis: " << astProgram.declarations.size() << "\n";
-    cout << "Comandos em config:       " << astProgram.configCommands.size() << "\n";
-    cout << "Comandos em repita:       " << astProgram.repitaCommands.size() << "\n";
+/* ------------------------------------------------------------------
+   Parser em streaming (yypush_parse)
+   ------------------------------------------------------------------ */
+StreamParser::StreamParser(ASTProgram& program, DiagnosticList& diagnostics, ParseListener* listener)
+    : ctx(&program, &diagnostics), state(yypstate_new()), line(1), openQuote(false),
+      status(YYPUSH_MORE) {
+    ctx.listener = listener;
+    if (state == NULL) status = 2;  // sem memória, como yyparse()
+}
+
+StreamParser::~StreamParser() {
+    if (state != NULL) yypstate_delete(state);
+}
 
-    generateCode(astProgram, "output.cpp");
+bool StreamParser::push(const Token& tok) {
+    YYSTYPE lval;
+    YYLTYPE lloc;
+    ctx.lastToken = tok;
+    int kind = tokenValue(tok, &lval, &ctx);
+    lloc.first_line = lloc.last_line = tok.line;
+    lloc.first_column = lloc.last_column = 0;
+    status = yypush_parse(state, kind, &lval, &lloc, &ctx);
+    return status == YYPUSH_MORE;
+}
+
+/**
+ * @brief Varre `pending` até `end` e entrega os tokens. Sem `last`, para
+ *        numa aspa sem fechamento (a string pode terminar no próximo
+ *        pedaço) e guarda o resto para a próxima varredura.
+ */
+void StreamParser::scan(const char* end, bool last) {
+    const char* begin = pending.data();
+    SimdLexer lexer(begin, end, line);
+    const char* resume = end;
+    int resumeLine = -1;
+
+    Token tok;
+    for (lexer.next(tok); tok.kind != 0 || last; lexer.next(tok)) {
+        if (!last && tok.kind == ERRO && tok.text[0] == '"') {
+            resume = tok.text;
+            resumeLine = tok.line;
+            break;
+        }
+        if (!push(tok) || tok.kind == 0) break;
+    }
 
-    return 0;
+    openQuote = resumeLine >= 0;
+    line = openQuote ? resumeLine : lexer.currentLine();
+    pending.erase(0, (size_t)(resume - begin));
+}
+
+bool StreamParser::feed(const char* data, size_t length) {
+    if (status != YYPUSH_MORE) return false;
+
+    size_t old = pending.size();
+    pending.append(data, length);
+
+    // Uma string aberta só pode fechar se chegou outra aspa
+    if (openQuote && memchr(pending.data() + old, '"', length) == NULL) return true;
+
+    // Só até a última quebra de linha: ali nenhum token (fora strings) continua
+    const char* begin = pending.data();
+    const char* nl = (const char*)memrchr(begin, '\n', pending.size());
+    if (nl != NULL) scan(nl + 1, false);
+    return status == YYPUSH_MORE;
+}
+
+int StreamParser::finish() {
+    if (status == YYPUSH_MORE) {
+        scan(pending.data() + pending.size(), true);
+    }
+    return status == YYPUSH_MORE ? 1 : status;
 }
 
 int valid_string(const char* str) {
@@ -0,0 +1,186 @@
+#include "pinflow.h"
+#include <algorithm>
+#include <utility>
+
+std::vector<uint32_t> constantPinClasses(const ASTProgram& program) {
+    const SymbolTable& symbols = program.symbols;
+    std::vector<uint32_t> classes(program.names.size(), NO_PIN_CLASS);
+    std::vector<std::pair<int, SymbolId> > known;
+    for (const VarDecl& decl : program.declarations) {
+        if (symbols.isConstant(decl.name)) {
+            known.push_back(std::make_pair(symbols.constValue(decl.name), decl.name));
+        }
+    }
+    std::sort(known.begin(), known.end());
+    for (size_t i = 0; i < known.size(); i++) {
+        bool first = i == 0 || known[i].first != known[i - 1].first;
+        classes[known[i].second] = first ? known[i].second : classes[known[i - 1].second];
+    }
+    return classes;
+}
+
+uint32_t PinSlots::slot(SymbolId id) {
+    if (id >= bySymbol.size()) bySymbol.resize(id + 1, NO_PIN_SLOT);
+    if (bySymbol[id] == NO_PIN_SLOT) {
+        bySymbol[id] = count++;
+        bySlot.push_back(id);
+    }
+    return bySymbol[id];
+}
+
+void PinStates::join(const PinStates& other) {
+    size_t n = pins.size() > other.pins.size() ? pins.size() : other.pins.size();
+    pins.resize(n, rest);
+    for (size_t i = 0; i < n; i++) {
+        pins[i] |= other.get((uint32_t)i);
+    }
+    rest |= other.rest;
+}
+
+bool PinFlow::redundant(const Command& cmd) const {
+    switch (cmd.cmdType) {
+        case CMD_CONFIG_PIN:
+            // pinMode também solta o pino do LEDC: só é redundante sem PWM
+            return (pin(cmd.configPin.pin) & (PIN_MODE_MASK | PIN_PWM_MASK))
+                   == (pinModeBit(cmd.configPin.mode) | PIN_PWM_NO);
+        case CMD_CONFIG_PWM:
+            return (pin(cmd.configPwm.pin) & PIN_PWM_MASK) == PIN_PWM_YES;
+        case CMD_LIGAR:
+            return (pin(cmd.digital.pin) & PIN_LEVEL_MASK) == PIN_LEVEL_HIGH;
+        case CMD_DESLIGAR:
+            return (pin(cmd.digital.pin) & PIN_LEVEL_MASK) == PIN_LEVEL_LOW;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Escreve o fato `mask` de `pin`. Nos outros pinos que podem ser
+ *        o mesmo número o valor novo só se torna possível.
+ */
+void PinFlow::write(SymbolId pin, unsigned mask, unsigned value) {
+    uint32_t s = slots.slot(pin);
+    uint32_t mineClass = classOf(pin);
+    PinState mine = pinSet(state.get(s), mask, value);
+    for (uint32_t i = 0; i < state.pins.size(); i++) {
+        if (pinsMayAlias(mineClass, classOf(slots.symbol(i)))) state.pins[i] |= (PinState)value;
+    }
+    state.rest |= (PinState)value;
+    state.set(s, mine);
+}
+
+/**
+ * @brief true se apply() pode mudar o estado por causa de `cmd`.
+ */
+bool PinFlow::touchesPins(const Command& cmd) const {
+    switch (cmd.cmdType) {
+        case CMD_CONFIG_PIN:
+        case CMD_CONFIG_PWM:
+        case CMD_PWM_ADJUST:
+        case CMD_LIGAR:
+        case CMD_DESLIGAR:
+            return true;
+        case CMD_ASSIGN:
+            return slots.find(cmd.assign.var) != NO_PIN_SLOT;
+        case CMD_LER_DIGITAL:
+        case CMD_LER_ANALOGICO:
+            return slots.find(cmd.readPin.var) != NO_PIN_SLOT;
+        default:
+            return false;
+    }
+}
+
+void PinFlow::apply(const Command& cmd) {
+    switch (cmd.cmdType) {
+        case CMD_CONFIG_PIN:
+            write(cmd.configPin.pin, PIN_MODE_MASK | PIN_PWM_MASK | PIN_LEVEL_MASK,
+                  pinModeBit(cmd.configPin.mode) | PIN_PWM_NO | PIN_LEVEL_UNKNOWN);
+            break;
+        case CMD_CONFIG_PWM:
+            write(cmd.configPwm.pin, PIN_PWM_MASK | PIN_LEVEL_MASK, PIN_PWM_YES | PIN_LEVEL_UNKNOWN);
+            break;
+        case CMD_PWM_ADJUST:
+            write(cmd.pwmAdjust.pin, PIN_LEVEL_MASK, PIN_LEVEL_UNKNOWN);
+            break;
+        case CMD_LIGAR:
+            write(cmd.digital.pin, PIN_LEVEL_MASK, PIN_LEVEL_HIGH);
+            break;
+        case CMD_DESLIGAR:
+            write(cmd.digital.pin, PIN_LEVEL_MASK, PIN_LEVEL_LOW);
+            break;
+
+        // A variável passa a apontar para outro pino, que pode estar em
+        // qualquer estado já visto: `rest` acumula todos eles
+        case CMD_ASSIGN:
+        case CMD_LER_DIGITAL:
+        case CMD_LER_ANALOGICO: {
+            SymbolId var = cmd.cmdType == CMD_ASSIGN ? cmd.assign.var : cmd.readPin.var;
+            uint32_t s = slots.find(var);
+            if (s != NO_PIN_SLOT) state.set(s, state.rest);
+        } break;
+
+        default:
+            break;
+    }
+}
+
+void PinFlow::enterLoop(const ControlFlowGraph& graph, BasicBlockId first, BasicBlockId end) {
+    // Qualquer valor que o corpo escreve pode chegar de volta ao
+    // cabeçalho; o resto vem de antes do laço
+    for (BasicBlockId id = first; id < end; id++) {
+        const BasicBlock& block = graph.blocks[id];
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            if (!touchesPins(*cmd)) continue;
+            PinStates before = state;
+            apply(*cmd);
+            state.join(before);
+        }
+    }
+}
+
+void PinFlow::forget() {
+    state.pins.assign(state.pins.size(), PIN_ANY);
+    state.rest = PIN_ANY;
+}
+
+void PinFlow::run(const ControlFlowGraph& graph) {
+    region(graph, graph.entry, NO_BASIC_BLOCK);
+}
+
+/**
+ * @brief Mesmo percurso de generateRegion (codegen.cpp), só com as
+ *        transferências.
+ */
+void PinFlow::region(const ControlFlowGraph& graph, BasicBlockId from, BasicBlockId stop) {
+    BasicBlockId id = from;
+    while (id != stop) {
+        const BasicBlock& block = graph.blocks[id];
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            if (!redundant(*cmd)) apply(*cmd);
+        }
+
+        if (block.term == TERM_RETURN) {
+            return;
+        }
+        if (block.term == TERM_JUMP) {
+            id = block.next;
+            continue;
+        }
+
+        if (block.origin->cmdType == CMD_WHILE) {
+            enterLoop(graph, block.next, block.join);
+            PinStates head = state;
+            region(graph, block.next, id);
+            state = std::move(head);
+        } else {
+            PinStates before = state;
+            region(graph, block.next, block.join);
+            if (block.other != block.join) {
+                std::swap(state, before);
+                region(graph, block.other, block.join);
+            }
+            state.join(before);
+        }
+        id = block.join;
+    }
+}
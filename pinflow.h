@@ -0,0 +1,190 @@
+#ifndef PINFLOW_H
+#define PINFLOW_H
+
+#include <stdint.h>
+#include <vector>
+#include "ast.h"
+#include "cfg.h"
+
+/* -------------------------------------------------
+ * 1) Estado de um pino
+ * ------------------------------------------------- */
+/**
+ * @brief Fatos de um pino num ponto do programa: modo (pinMode), PWM
+ *        (ledcAttachPin) e último nível escrito (digitalWrite). Cada fato
+ *        é o conjunto dos valores possíveis, um bit por valor; juntar
+ *        dois caminhos é o OU dos bits, e um fato é conhecido quando só
+ *        tem um bit.
+ */
+typedef uint8_t PinState;
+
+enum PinStateBits {
+    PIN_MODE_NONE     = 0x01,  // nunca configurado
+    PIN_MODE_SAIDA    = 0x02,
+    PIN_MODE_ENTRADA  = 0x04,
+    PIN_MODE_MASK     = 0x07,
+
+    PIN_PWM_NO        = 0x08,
+    PIN_PWM_YES       = 0x10,
+    PIN_PWM_MASK      = 0x18,
+
+    PIN_LEVEL_LOW     = 0x20,
+    PIN_LEVEL_HIGH    = 0x40,
+    PIN_LEVEL_UNKNOWN = 0x80,  // sem digitalWrite desde a última mudança
+    PIN_LEVEL_MASK    = 0xE0
+};
+
+const PinState PIN_INITIAL = PIN_MODE_NONE | PIN_PWM_NO | PIN_LEVEL_UNKNOWN;
+const PinState PIN_ANY = 0xFF;
+
+/**
+ * @brief Troca o fato `mask` de `s` por `value`.
+ */
+inline PinState pinSet(PinState s, unsigned mask, unsigned value) {
+    return (PinState)((s & ~mask) | value);
+}
+
+/**
+ * @brief Bit do modo de "configurar ... como saida|entrada".
+ */
+inline unsigned pinModeBit(PinMode mode) {
+    return mode == PINO_ENTRADA ? PIN_MODE_ENTRADA : PIN_MODE_SAIDA;
+}
+
+/* -------------------------------------------------
+ * 2) Pinos que podem ser o mesmo
+ * ------------------------------------------------- */
+const uint32_t NO_PIN_CLASS = 0xFFFFFFFFu;
+
+/**
+ * @brief Classe de pino de cada variável (por SymbolId), a partir das
+ *        constantes de propagateConstants (constprop.h): variáveis
+ *        constantes com o mesmo número ficam na mesma classe (o menor
+ *        SymbolId entre elas); as outras ficam em NO_PIN_CLASS (podem
+ *        ser qualquer pino).
+ */
+std::vector<uint32_t> constantPinClasses(const ASTProgram& program);
+
+/**
+ * @brief true se dois pinos, de classes `a` e `b`, podem ter o mesmo
+ *        número: só não podem se os dois são constantes diferentes.
+ */
+inline bool pinsMayAlias(uint32_t a, uint32_t b) {
+    return a == NO_PIN_CLASS || b == NO_PIN_CLASS || a == b;
+}
+
+/* -------------------------------------------------
+ * 3) Estado de todos os pinos
+ * ------------------------------------------------- */
+const uint32_t NO_PIN_SLOT = 0xFFFFFFFFu;
+
+/**
+ * @brief Numeração densa dos pinos (SymbolId -> slot), feita à medida que
+ *        eles aparecem em comandos de pino. Variáveis que nunca são
+ *        usadas como pino não ocupam espaço nos estados.
+ */
+class PinSlots {
+public:
+    PinSlots() : count(0) {}
+
+    uint32_t slot(SymbolId id);              // cria se preciso
+    uint32_t find(SymbolId id) const {       // NO_PIN_SLOT se não existe
+        return id < bySymbol.size() ? bySymbol[id] : NO_PIN_SLOT;
+    }
+    uint32_t size() const { return count; }
+    SymbolId symbol(uint32_t slot) const { return bySlot[slot]; }
+
+private:
+    std::vector<uint32_t> bySymbol;
+    std::vector<SymbolId> bySlot;
+    uint32_t count;
+};
+
+/**
+ * @brief Estado de todos os pinos num ponto. `pins` pode ser mais curto
+ *        que o número de slots: os pinos que ainda não apareceram valem
+ *        `rest`. Na geração de código `rest` também contém o estado de
+ *        todos os pinos (qualquer pino físico está num estado de `rest`).
+ */
+struct PinStates {
+    std::vector<PinState> pins;
+    PinState rest;
+
+    explicit PinStates(PinState r = PIN_INITIAL) : rest(r) {}
+
+    PinState get(uint32_t slot) const { return slot < pins.size() ? pins[slot] : rest; }
+    void set(uint32_t slot, PinState s) {
+        if (slot >= pins.size()) pins.resize(slot + 1, rest);
+        pins[slot] = s;
+    }
+
+    /**
+     * @brief Junção com outro caminho (OU de cada pino).
+     */
+    void join(const PinStates& other);
+};
+
+/* -------------------------------------------------
+ * 4) Análise para a geração de código
+ * ------------------------------------------------- */
+/**
+ * @brief Análise para frente do estado dos pinos, comando a comando, com
+ *        junção no fim de cada se e ponto fixo no cabeçalho de cada
+ *        enquanto (e de repita). A geração de código pergunta redundant()
+ *        antes de cada comando e omite pinMode/ledcSetup+ledcAttachPin/
+ *        digitalWrite que não mudariam nada.
+ *
+ * Duas variáveis podem ter o mesmo número de pino, então uma escrita num
+ * pino também entra como possível nos outros, menos nos que são
+ * constantes com outro número (constantPinClasses); uma atribuição à
+ * variável do pino troca o que se sabia dele por `rest`.
+ */
+class PinFlow {
+public:
+    PinFlow() {}
+    explicit PinFlow(const std::vector<uint32_t>& classes) : pinClass(classes) {}
+
+    PinStates state;  // estado no ponto atual
+
+    /**
+     * @brief true se `cmd` não muda o estado (pode ser omitido).
+     */
+    bool redundant(const Command& cmd) const;
+
+    /**
+     * @brief Função de transferência de um comando que foi gerado.
+     */
+    void apply(const Command& cmd);
+
+    /**
+     * @brief Entrada de um laço cujo corpo são os blocos [first, end):
+     *        acrescenta ao estado tudo o que o corpo pode escrever, o que
+     *        já é o ponto fixo do cabeçalho.
+     */
+    void enterLoop(const ControlFlowGraph& graph, BasicBlockId first, BasicBlockId end);
+
+    /**
+     * @brief Esquece tudo (qualquer valor é possível em qualquer pino).
+     */
+    void forget();
+
+    /**
+     * @brief Percorre o grafo inteiro, sem gerar nada (ex.: estado no fim
+     *        de setup(), que é a entrada de loop()).
+     */
+    void run(const ControlFlowGraph& graph);
+
+private:
+    PinSlots slots;
+    std::vector<uint32_t> pinClass;  // constantPinClasses (vazio: nenhuma constante)
+
+    PinState pin(SymbolId id) const { return state.get(slots.find(id)); }
+    uint32_t classOf(SymbolId id) const {
+        return id < pinClass.size() ? pinClass[id] : NO_PIN_CLASS;
+    }
+    bool touchesPins(const Command& cmd) const;
+    void write(SymbolId pin, unsigned mask, unsigned value);
+    void region(const ControlFlowGraph& graph, BasicBlockId from, BasicBlockId stop);
+};
+
+#endif // PINFLOW_H
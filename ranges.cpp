@@ -0,0 +1,592 @@
+#include "ranges.h"
+#include "trace.h"
+#include <limits.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+const uint32_t NO_RANGE_SLOT = 0xFFFFFFFFu;
+
+// Estados de entrada de todos os blocos ficam num vetor só; acima disso
+// (muitos blocos vezes muitas variáveis) a análise desiste e todo
+// ajustarPWM do grafo é limitado
+const size_t MAX_RANGE_INTERVALS = 8u * 1024 * 1024;  // 64 MiB
+
+// Mudanças no cabeçalho de um laço antes de alargar
+const uint32_t WIDEN_AFTER = 3;
+
+const Interval FULL_INT = {INT_MIN, INT_MAX};
+
+// Limites dos tipos estreitos (chooseWidths): sempre entre os degraus do
+// alargamento
+const int32_t WIDTH_BOUNDS[] = {-32768, -128, 0, 127, 255, 32767, 65535};
+
+/**
+ * @brief [lo, hi] calculado em 64 bits; fora do int, a conta estoura e
+ *        vale qualquer int.
+ */
+static Interval fromWide(int64_t lo, int64_t hi) {
+    if (lo < INT_MIN || hi > INT_MAX) return FULL_INT;
+    Interval r = {(int32_t)lo, (int32_t)hi};
+    return r;
+}
+
+static int64_t min64(int64_t a, int64_t b) { return a < b ? a : b; }
+static int64_t max64(int64_t a, int64_t b) { return a > b ? a : b; }
+
+/**
+ * @brief Menor e maior de x/y, x em [a0, a1] e y em [b0, b1] sem o zero:
+ *        com o divisor de sinal fixo, a divisão (truncada) é monótona em
+ *        cada operando, então os extremos estão nos cantos.
+ */
+static void divCorners(int64_t a0, int64_t a1, int64_t b0, int64_t b1, int64_t& lo, int64_t& hi) {
+    int64_t q[4] = {a0 / b0, a0 / b1, a1 / b0, a1 / b1};
+    for (int64_t v : q) {
+        lo = min64(lo, v);
+        hi = max64(hi, v);
+    }
+}
+
+/**
+ * @brief Resultado de uma comparação: [1, 1] se sempre vale, [0, 0] se
+ *        nunca vale, [0, 1] se depende.
+ */
+static Interval compare(BinaryOp op, Interval a, Interval b) {
+    bool always = false, never = false;
+    switch (op) {
+        case OP_MENOR:       always = a.hi < b.lo;  never = a.lo >= b.hi; break;
+        case OP_MAIOR:       always = a.lo > b.hi;  never = a.hi <= b.lo; break;
+        case OP_MENOR_IGUAL: always = a.hi <= b.lo; never = a.lo > b.hi;  break;
+        case OP_MAIOR_IGUAL: always = a.lo >= b.hi; never = a.hi < b.lo;  break;
+        case OP_IGUAL_IGUAL:
+        case OP_DIFERENTE: {
+            bool same = a.lo == a.hi && b.lo == b.hi && a.lo == b.lo;
+            bool disjoint = a.hi < b.lo || b.hi < a.lo;
+            always = op == OP_IGUAL_IGUAL ? same : disjoint;
+            never = op == OP_IGUAL_IGUAL ? disjoint : same;
+        } break;
+        default:
+            break;
+    }
+    Interval r = {never ? 0 : always ? 1 : 0, always ? 1 : never ? 0 : 1};
+    return r;
+}
+
+static Interval binary(BinaryOp op, Interval a, Interval b) {
+    int64_t a0 = a.lo, a1 = a.hi, b0 = b.lo, b1 = b.hi;
+    switch (op) {
+        case OP_MAIS:
+            return fromWide(a0 + b0, a1 + b1);
+        case OP_MENOS:
+            return fromWide(a0 - b1, a1 - b0);
+        case OP_VEZES: {
+            int64_t p[4] = {a0 * b0, a0 * b1, a1 * b0, a1 * b1};
+            int64_t lo = p[0], hi = p[0];
+            for (int64_t v : p) {
+                lo = min64(lo, v);
+                hi = max64(hi, v);
+            }
+            return fromWide(lo, hi);
+        }
+        case OP_DIV: {
+            if (b0 == 0 && b1 == 0) return FULL_INT;  // sempre divisão por zero
+            int64_t lo = INT64_MAX, hi = INT64_MIN;
+            if (b0 < 0) divCorners(a0, a1, b0, min64(b1, -1), lo, hi);
+            if (b1 > 0) divCorners(a0, a1, max64(b0, 1), b1, lo, hi);
+            return fromWide(lo, hi);  // INT_MIN / -1 estoura
+        }
+        default:
+            return compare(op, a, b);
+    }
+}
+
+/**
+ * @brief Comparação vista do outro lado: `e < x` é `x > e`.
+ */
+static BinaryOp mirrorOp(BinaryOp op) {
+    switch (op) {
+        case OP_MENOR:       return OP_MAIOR;
+        case OP_MAIOR:       return OP_MENOR;
+        case OP_MENOR_IGUAL: return OP_MAIOR_IGUAL;
+        case OP_MAIOR_IGUAL: return OP_MENOR_IGUAL;
+        default:             return op;
+    }
+}
+
+/**
+ * @brief Comparação que vale quando `op` não vale.
+ */
+static BinaryOp negateOp(BinaryOp op) {
+    switch (op) {
+        case OP_MENOR:       return OP_MAIOR_IGUAL;
+        case OP_MAIOR:       return OP_MENOR_IGUAL;
+        case OP_MENOR_IGUAL: return OP_MAIOR;
+        case OP_MAIOR_IGUAL: return OP_MENOR;
+        case OP_IGUAL_IGUAL: return OP_DIFERENTE;
+        default:             return OP_IGUAL_IGUAL;
+    }
+}
+
+static const Expr* stripParens(const Expr* e) {
+    while (e->kind == EXPR_PARENTESES) e = e->left;
+    return e;
+}
+
+bool RangeState::join(const RangeState& other) {
+    if (!other.reachable) return false;
+    if (!reachable) {
+        *this = other;
+        return true;
+    }
+    bool changed = false;
+    for (size_t i = 0; i < vars.size(); i++) {
+        if (other.vars[i].lo < vars[i].lo) {
+            vars[i].lo = other.vars[i].lo;
+            changed = true;
+        }
+        if (other.vars[i].hi > vars[i].hi) {
+            vars[i].hi = other.vars[i].hi;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+RangeAnalysis::RangeAnalysis(ASTProgram& p, DiagnosticList& d, bool duty)
+    : program(p), diagnostics(d), recording(false), checkDuty(duty), proven(0), clamped(0) {}
+
+void RangeAnalysis::start() {
+    slots.assign(program.names.size(), NO_RANGE_SLOT);
+    booleans.clear();
+    state.vars.clear();
+    for (const VarDecl& decl : program.declarations) {
+        if (decl.type == VAR_TEXTO || slots[decl.name] != NO_RANGE_SLOT) continue;
+        slots[decl.name] = (uint32_t)state.vars.size();
+        booleans.push_back(decl.type == VAR_BOOLEANO);
+        Interval zero = {0, 0};
+        state.vars.push_back(zero);
+    }
+    state.reachable = true;
+    stored = state.vars;
+}
+
+void RangeAnalysis::forget() {
+    unknown(state);
+    state.reachable = true;
+}
+
+/**
+ * @brief Qualquer valor em toda variável (booleano: 0..1).
+ */
+void RangeAnalysis::unknown(RangeState& s) const {
+    s.vars.resize(booleans.size());
+    for (size_t i = 0; i < s.vars.size(); i++) {
+        Interval any = {booleans[i] ? 0 : INT_MIN, booleans[i] ? 1 : INT_MAX};
+        s.vars[i] = any;
+    }
+}
+
+int32_t RangeAnalysis::widenUp(int32_t hi) const {
+    std::vector<int32_t>::const_iterator t = std::lower_bound(thresholds.begin(), thresholds.end(), hi);
+    return t == thresholds.end() ? INT_MAX : *t;
+}
+
+int32_t RangeAnalysis::widenDown(int32_t lo) const {
+    std::vector<int32_t>::const_iterator t = std::upper_bound(thresholds.begin(), thresholds.end(), lo);
+    return t == thresholds.begin() ? INT_MIN : *(t - 1);
+}
+
+uint32_t RangeAnalysis::slot(SymbolId id) const {
+    return id < slots.size() ? slots[id] : NO_RANGE_SLOT;
+}
+
+Interval RangeAnalysis::eval(const RangeState& s, const Expr* root) {
+    // Em largura, cada nó entra depois do pai e os filhos ficam juntos:
+    // de trás para frente os operandos já têm valor
+    nodes.clear();
+    children.clear();
+    nodes.push_back(root);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const Expr* e = nodes[i];
+        children.push_back((uint32_t)nodes.size());
+        if (e->left) nodes.push_back(e->left);
+        if (e->right) nodes.push_back(e->right);
+    }
+
+    values.resize(nodes.size());
+    for (size_t i = nodes.size(); i-- > 0;) {
+        const Expr* e = nodes[i];
+        Interval v = FULL_INT;
+        switch (e->kind) {
+            case EXPR_NUMERO:
+                v.lo = v.hi = e->value;
+                break;
+            case EXPR_IDENT: {
+                uint32_t k = slot(e->symbol);
+                if (k != NO_RANGE_SLOT) v = s.vars[k];
+            } break;
+            case EXPR_PARENTESES:
+                v = values[children[i]];
+                break;
+            case EXPR_BINARIA:
+                v = binary(e->op, values[children[i]], values[children[i] + 1]);
+                break;
+            default:
+                break;  // texto
+        }
+        values[i] = v;
+    }
+    return values[0];
+}
+
+void RangeAnalysis::assign(RangeState& s, SymbolId var, Interval value) {
+    uint32_t k = slot(var);
+    if (k == NO_RANGE_SLOT) return;
+    if (booleans[k]) {
+        // Conversão para bool: só 0 vira false
+        bool canBeZero = value.lo <= 0 && value.hi >= 0;
+        bool canBeOther = value.lo != 0 || value.hi != 0;
+        value.lo = canBeZero ? 0 : 1;
+        value.hi = canBeOther ? 1 : 0;
+    }
+    s.vars[k] = value;
+    if (!recording) return;
+    if (value.lo < stored[k].lo) stored[k].lo = value.lo;
+    if (value.hi > stored[k].hi) stored[k].hi = value.hi;
+}
+
+void RangeAnalysis::narrow(RangeState& s, SymbolId var, BinaryOp op, Interval other, bool truth) {
+    uint32_t k = slot(var);
+    if (k == NO_RANGE_SLOT) return;
+    if (!truth) op = negateOp(op);
+
+    int64_t lo = s.vars[k].lo, hi = s.vars[k].hi;
+    switch (op) {
+        case OP_MENOR:       hi = min64(hi, (int64_t)other.hi - 1); break;
+        case OP_MENOR_IGUAL: hi = min64(hi, other.hi); break;
+        case OP_MAIOR:       lo = max64(lo, (int64_t)other.lo + 1); break;
+        case OP_MAIOR_IGUAL: lo = max64(lo, other.lo); break;
+        case OP_IGUAL_IGUAL:
+            lo = max64(lo, other.lo);
+            hi = min64(hi, other.hi);
+            break;
+        case OP_DIFERENTE:
+            // Só dá para tirar um valor da ponta do intervalo
+            if (other.lo == other.hi) {
+                if (lo == other.lo) lo++;
+                if (hi == other.lo) hi--;
+            }
+            break;
+        default:
+            break;
+    }
+    if (lo > hi) {
+        s.reachable = false;  // a condição nunca vale (ou nunca falha) aqui
+        return;
+    }
+    s.vars[k].lo = (int32_t)lo;
+    s.vars[k].hi = (int32_t)hi;
+}
+
+void RangeAnalysis::refine(RangeState& s, const Expr* cond, bool truth) {
+    cond = stripParens(cond);
+    Interval c = eval(s, cond);
+    if (truth ? (c.lo == 0 && c.hi == 0) : (c.lo > 0 || c.hi < 0)) {
+        s.reachable = false;
+        return;
+    }
+
+    // "se x entao": x != 0
+    if (cond->kind == EXPR_IDENT) {
+        Interval zero = {0, 0};
+        narrow(s, cond->symbol, OP_DIFERENTE, zero, truth);
+        return;
+    }
+    if (cond->kind != EXPR_BINARIA || cond->op <= OP_DIV) return;
+
+    const Expr* left = stripParens(cond->left);
+    const Expr* right = stripParens(cond->right);
+    if (left->kind == EXPR_IDENT) {
+        narrow(s, left->symbol, cond->op, eval(s, right), truth);
+    }
+    if (s.reachable && right->kind == EXPR_IDENT) {
+        narrow(s, right->symbol, mirrorOp(cond->op), eval(s, left), truth);
+    }
+}
+
+void RangeAnalysis::transfer(RangeState& s, const BasicBlock& block) {
+    for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+        switch (cmd->cmdType) {
+            case CMD_ASSIGN:
+                assign(s, cmd->assign.var, eval(s, cmd->assign.value));
+                break;
+            case CMD_LER_DIGITAL: {
+                Interval bit = {0, 1};
+                assign(s, cmd->readPin.var, bit);
+            } break;
+            case CMD_LER_ANALOGICO: {
+                Interval adc = {0, 4095};
+                assign(s, cmd->readPin.var, adc);
+            } break;
+            case CMD_PWM_ADJUST: {
+                const PwmAdjustCmd& pwm = cmd->pwmAdjust;
+                if (!checkDuty || !s.reachable || !program.symbols.hasPwm(pwm.pin)) break;
+                Interval v = eval(s, pwm.value);
+                int max = program.symbols.pwmMaxDuty(pwm.pin);
+                if (v.lo >= 0 && v.hi <= max) {
+                    pwm.duty = DUTY_PROVEN;
+                } else if (v.hi < 0 || v.lo > max) {
+                    pwm.duty = DUTY_OVERFLOW;
+                } else {
+                    pwm.duty = DUTY_CLAMP;
+                }
+            } break;
+            default:
+                break;
+        }
+    }
+}
+
+bool RangeAnalysis::run(const ControlFlowGraph& graph, bool repeats) {
+    size_t n = graph.blocks.size();
+    size_t width = state.vars.size();
+
+    // Um ajustarPWM que a análise não alcança fica limitado
+    for (const BasicBlock& block : graph.blocks) {
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            if (checkDuty && cmd->cmdType == CMD_PWM_ADJUST) cmd->pwmAdjust.duty = DUTY_CLAMP;
+        }
+    }
+    if (n * width > MAX_RANGE_INTERVALS) {
+        TRACE(TRACE_SEMANTIC, TRACE_INFO, "Faixas: %zu blocos x %zu variaveis, grande demais",
+              n, width);
+        // Toda variável escrita no grafo pode guardar qualquer valor
+        recording = true;
+        for (const BasicBlock& block : graph.blocks) {
+            for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+                if (cmd->cmdType == CMD_ASSIGN) assign(state, cmd->assign.var, FULL_INT);
+                if (cmd->cmdType == CMD_LER_DIGITAL || cmd->cmdType == CMD_LER_ANALOGICO) {
+                    assign(state, cmd->readPin.var, FULL_INT);
+                }
+            }
+        }
+        recording = false;
+        forget();
+        return report(graph);
+    }
+    if (!state.reachable) {
+        // O que vem antes nunca termina
+        record(graph, std::vector<Interval>(), std::vector<uint8_t>(n, 0));
+        return report(graph);
+    }
+
+    // Alvos de arestas de volta (cabeçalhos de enquanto e, com `repeats`,
+    // o começo do grafo): onde o alargamento acontece
+    std::vector<uint8_t> loopHead(n, 0);
+    for (BasicBlockId id = 0; id < n; id++) {
+        const BasicBlock& block = graph.blocks[id];
+        if (block.term == TERM_RETURN) {
+            if (repeats) loopHead[graph.entry] = 1;
+            continue;
+        }
+        if (block.next <= id) loopHead[block.next] = 1;
+        if (block.term == TERM_BRANCH && block.other <= id) loopHead[block.other] = 1;
+    }
+
+    // Degraus do alargamento: os números das condições do grafo (e os
+    // vizinhos deles) e os limites dos tipos. Um limite que cresce para no
+    // próximo degrau em vez de ir direto ao extremo do int, então um
+    // contador zerado por `se c > 100` fica em 0..100
+    thresholds.assign(WIDTH_BOUNDS, WIDTH_BOUNDS + sizeof(WIDTH_BOUNDS) / sizeof(WIDTH_BOUNDS[0]));
+    for (const BasicBlock& block : graph.blocks) {
+        if (block.term != TERM_BRANCH) continue;
+        nodes.clear();
+        nodes.push_back(block.condition);
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const Expr* e = nodes[i];
+            if (e->left) nodes.push_back(e->left);
+            if (e->right) nodes.push_back(e->right);
+            if (e->kind != EXPR_NUMERO) continue;
+            for (int64_t v = (int64_t)e->value - 1; v <= (int64_t)e->value + 1; v++) {
+                if (v >= INT_MIN && v <= INT_MAX) thresholds.push_back((int32_t)v);
+            }
+        }
+    }
+    std::sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+
+    // Estado de entrada de cada bloco; a lista de trabalho sai sempre pelo
+    // menor índice (ordem do fonte), então um bloco é visto depois dos
+    // que chegam nele pela frente
+    std::vector<Interval> in(n * width);
+    std::vector<uint8_t> reached(n, 0);
+    std::vector<uint8_t> queued(n, 0);
+    std::vector<uint32_t> changes(n, 0);
+    std::priority_queue<BasicBlockId, std::vector<BasicBlockId>, std::greater<BasicBlockId> > work;
+
+    auto propagate = [&](BasicBlockId to, const RangeState& s) {
+        if (!s.reachable) return;
+        Interval* row = in.data() + to * width;
+        bool changed = false;
+        if (!reached[to]) {
+            reached[to] = 1;
+            for (size_t i = 0; i < width; i++) row[i] = s.vars[i];
+            changed = true;
+        } else {
+            bool widen = loopHead[to] && ++changes[to] > WIDEN_AFTER;
+            for (size_t i = 0; i < width; i++) {
+                if (s.vars[i].lo < row[i].lo) {
+                    row[i].lo = widen ? widenDown(s.vars[i].lo) : s.vars[i].lo;
+                    changed = true;
+                }
+                if (s.vars[i].hi > row[i].hi) {
+                    row[i].hi = widen ? widenUp(s.vars[i].hi) : s.vars[i].hi;
+                    changed = true;
+                }
+            }
+        }
+        if (changed && !queued[to]) {
+            queued[to] = 1;
+            work.push(to);
+        }
+    };
+
+    // Saída de um bloco (com a entrada em `in`) para os sucessores
+    RangeState s, other;
+    auto step = [&](BasicBlockId id, auto&& to) {
+        const BasicBlock& block = graph.blocks[id];
+        s.vars.assign(in.begin() + id * width, in.begin() + (id + 1) * width);
+        s.reachable = true;
+        transfer(s, block);
+
+        if (block.term == TERM_RETURN) {
+            if (repeats) to(graph.entry, s);
+        } else if (block.term == TERM_JUMP) {
+            to(block.next, s);
+        } else {
+            other = s;
+            refine(s, block.condition, true);
+            to(block.next, s);
+            refine(other, block.condition, false);
+            to(block.other, other);
+        }
+    };
+
+    propagate(graph.entry, state);
+    while (!work.empty()) {
+        BasicBlockId id = work.top();
+        work.pop();
+        queued[id] = 0;
+        step(id, propagate);
+    }
+
+    // Uma volta de estreitamento: as entradas são refeitas uma vez a partir
+    // do ponto fixo, sem alargar, o que tira o que o alargamento passou do
+    // ponto (e ainda vale para toda execução)
+    std::vector<Interval> narrowed(n * width);
+    std::vector<uint8_t> narrowedReached(n, 0);
+    auto collect = [&](BasicBlockId to, const RangeState& from) {
+        if (!from.reachable) return;
+        Interval* row = narrowed.data() + to * width;
+        for (size_t i = 0; i < width; i++) {
+            if (!narrowedReached[to]) {
+                row[i] = from.vars[i];
+                continue;
+            }
+            if (from.vars[i].lo < row[i].lo) row[i].lo = from.vars[i].lo;
+            if (from.vars[i].hi > row[i].hi) row[i].hi = from.vars[i].hi;
+        }
+        narrowedReached[to] = 1;
+    };
+    collect(graph.entry, state);
+    for (BasicBlockId id = 0; id < n; id++) {
+        if (reached[id]) step(id, collect);
+    }
+    in.swap(narrowed);
+    reached.swap(narrowedReached);
+
+    record(graph, in, reached);
+
+    // O estado segue com o do fim do grafo
+    if (reached[graph.exit]) {
+        state.vars.assign(in.begin() + graph.exit * width, in.begin() + (graph.exit + 1) * width);
+    } else {
+        state.reachable = false;
+    }
+    return report(graph);
+}
+
+/**
+ * @brief Junta em `stored` os valores que cada bloco guarda, com a
+ *        entrada final de `in`, e marca os ajustarPWM com ela. A geração
+ *        de código só tira os ramos que a dobra de constantes decide, então
+ *        um bloco que a análise não alcança também conta, com qualquer
+ *        valor nas variáveis (e o ajustarPWM dele continua limitado).
+ */
+void RangeAnalysis::record(const ControlFlowGraph& graph, const std::vector<Interval>& in,
+                           const std::vector<uint8_t>& reached) {
+    size_t width = state.vars.size();
+    RangeState s;
+    recording = true;
+    for (BasicBlockId id = 0; id < graph.blocks.size(); id++) {
+        if (reached[id]) {
+            s.vars.assign(in.begin() + id * width, in.begin() + (id + 1) * width);
+            s.reachable = true;
+        } else {
+            unknown(s);
+            s.reachable = false;
+        }
+        transfer(s, graph.blocks[id]);
+    }
+    recording = false;
+}
+
+/**
+ * @brief Conta os ajustarPWM do grafo, marca os pinos limitados e acusa
+ *        os que estão sempre fora da faixa.
+ */
+bool RangeAnalysis::report(const ControlFlowGraph& graph) {
+    if (!checkDuty) return true;
+    bool ok = true;
+    size_t seen = 0;
+    for (const BasicBlock& block : graph.blocks) {
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            if (cmd->cmdType != CMD_PWM_ADJUST) continue;
+            const PwmAdjustCmd& pwm = cmd->pwmAdjust;
+            seen++;
+            if (pwm.duty == DUTY_PROVEN) {
+                proven++;
+            } else if (pwm.duty == DUTY_CLAMP) {
+                clamped++;
+                program.symbols.setDutyClamp(pwm.pin);
+            } else if (pwm.duty == DUTY_OVERFLOW) {
+                // O valor no texto separa os vários ajustarPWM de um pino
+                diagnostics.report(DIAG_SEMANTICO, cmd->line,
+                                   "Erro semântico: valor %s de 'ajustarPWM' em '%s' sempre fora de "
+                                   "0..%d (resolução de %d bits). (linha %d)",
+                                   exprText(pwm.value, program).c_str(), program.names.cstr(pwm.pin),
+                                   program.symbols.pwmMaxDuty(pwm.pin), program.symbols.pwmResol(pwm.pin),
+                                   cmd->line);
+                ok = false;
+            }
+        }
+    }
+    if (seen != 0) {
+        TRACE(TRACE_SEMANTIC, TRACE_INFO, "Faixas: %zu ajustarPWM provados, %zu limitados (total)",
+              proven, clamped);
+    }
+    return ok;
+}
+
+void RangeAnalysis::chooseWidths() {
+    SymbolTable& symbols = program.symbols;
+    size_t narrowed = 0;
+    for (const VarDecl& decl : program.declarations) {
+        uint32_t k = slot(decl.name);
+        if (k == NO_RANGE_SLOT || booleans[k]) continue;
+        IntWidth width = intWidthFor(stored[k].lo, stored[k].hi);
+        symbols.setIntWidth(decl.name, width);
+        if (width != INT_WIDTH_32) narrowed++;
+    }
+    TRACE(TRACE_SEMANTIC, TRACE_INFO, "Faixas: %zu inteiros em tipos estreitos", narrowed);
+}
@@ -0,0 +1,140 @@
+#ifndef RANGES_H
+#define RANGES_H
+
+#include <stdint.h>
+#include <vector>
+#include "ast.h"
+#include "cfg.h"
+#include "diagnostics.h"
+
+/* -------------------------------------------------
+ * 1) Intervalos
+ * ------------------------------------------------- */
+/**
+ * @brief Valores possíveis de um inteiro: [lo, hi], vazio se lo > hi.
+ *        Uma conta que pode estourar o int de 32 bits dá o int inteiro.
+ */
+struct Interval {
+    int32_t lo;
+    int32_t hi;
+
+    bool empty() const { return lo > hi; }
+};
+
+/**
+ * @brief Intervalo de cada variável inteiro/booleano num ponto do
+ *        programa. `reachable` false: nenhuma execução chega ali.
+ */
+struct RangeState {
+    std::vector<Interval> vars;  // por slot (RangeAnalysis)
+    bool reachable;
+
+    RangeState() : reachable(false) {}
+
+    /**
+     * @brief Junção com outro caminho (menor lo, maior hi).
+     * @return true se o estado mudou.
+     */
+    bool join(const RangeState& other);
+};
+
+/* -------------------------------------------------
+ * 2) Análise dos valores de ajustarPWM
+ * ------------------------------------------------- */
+/**
+ * @brief Análise de intervalos para frente, bloco a bloco, que decide
+ *        para cada ajustarPWM se o valor fica em [0, 2^resol - 1]
+ *        (resolução do primeiro configurarPWM do pino):
+ *
+ * - sempre dentro: DUTY_PROVEN, e o ledcWrite sai direto;
+ * - talvez fora: DUTY_CLAMP, e o valor passa por limitarDuty() (sem
+ *   desvios) no código gerado; o pino fica marcado em program.symbols;
+ * - sempre fora (em toda execução que chega ao comando): DUTY_OVERFLOW
+ *   e um erro semântico.
+ *
+ * As variáveis começam em 0 (globais). As condições de se/enquanto
+ * estreitam a variável comparada em cada ramo (ex.: `x < 256` dá
+ * x <= 255 no corpo); lerDigital dá 0..1 e lerAnalogico 0..4095 (ADC de
+ * 12 bits do ESP32). No cabeçalho de um laço, depois de algumas voltas
+ * sem estabilizar, o limite que cresce pula para o próximo degrau (os
+ * números das condições do grafo, os limites dos tipos estreitos e, por
+ * fim, o extremo do int), o que garante o fim da análise; depois do ponto
+ * fixo, uma volta sem alargar estreita o resultado.
+ *
+ * O resultado fica em PwmAdjustCmd::duty, que a geração de código lê.
+ *
+ * A mesma análise junta, por variável inteiro, todo valor que ela chega a
+ * guardar (0 da inicialização, atribuições, leituras de pino), inclusive
+ * nos blocos que ela não alcança, que continuam no código gerado; com isso
+ * chooseWidths() escolhe o menor tipo C++ que comporta a variável
+ * (uint8_t, uint16_t, ...). As contas continuam em int (promoção do C++),
+ * e o valor guardado nunca sai do tipo, então nada muda no programa.
+ */
+class RangeAnalysis {
+public:
+    /**
+     * @param checkDuty false: só junta os valores guardados (ajustarPWM fica
+     *        DUTY_UNCHECKED e não há erro de faixa).
+     */
+    RangeAnalysis(ASTProgram& program, DiagnosticList& diagnostics, bool checkDuty = true);
+
+    /**
+     * @brief Estado inicial: toda variável declarada vale 0.
+     */
+    void start();
+
+    /**
+     * @brief Nada se sabe sobre nenhuma variável (entrada de loop() na
+     *        compilação em streaming, sem a volta de repita).
+     */
+    void forget();
+
+    /**
+     * @brief Analisa o grafo a partir do estado atual, que passa a ser o
+     *        do fim do grafo. Com `repeats`, o fim volta para o começo
+     *        (repita).
+     * @return false se algum ajustarPWM está sempre fora da faixa.
+     */
+    bool run(const ControlFlowGraph& graph, bool repeats);
+
+    /**
+     * @brief Tipo C++ de cada inteiro (program.symbols) pelos valores
+     *        guardados nos grafos analisados até aqui.
+     */
+    void chooseWidths();
+
+private:
+    ASTProgram& program;
+    DiagnosticList& diagnostics;
+
+    std::vector<uint32_t> slots;   // SymbolId -> slot (NO_RANGE_SLOT se não é inteiro/booleano)
+    std::vector<uint8_t> booleans; // por slot: 1 se a variável é booleano (só 0..1)
+    RangeState state;
+    std::vector<Interval> stored;  // por slot: união dos valores já guardados
+    bool recording;                // assign() junta em `stored` (record())
+    bool checkDuty;
+    size_t proven;
+    size_t clamped;
+
+    // Avaliação de expressões sem recursão (nós em largura, de trás para frente)
+    std::vector<const Expr*> nodes;
+    std::vector<uint32_t> children;  // índice do primeiro filho de cada nó
+    std::vector<Interval> values;
+
+    std::vector<int32_t> thresholds;  // degraus do alargamento (ordenados)
+
+    uint32_t slot(SymbolId id) const;
+    int32_t widenUp(int32_t hi) const;
+    int32_t widenDown(int32_t lo) const;
+    void unknown(RangeState& s) const;
+    Interval eval(const RangeState& s, const Expr* root);
+    void assign(RangeState& s, SymbolId var, Interval value);
+    void refine(RangeState& s, const Expr* cond, bool truth);
+    void narrow(RangeState& s, SymbolId var, BinaryOp op, Interval other, bool truth);
+    void transfer(RangeState& s, const BasicBlock& block);
+    void record(const ControlFlowGraph& graph, const std::vector<Interval>& in,
+                const std::vector<uint8_t>& reached);
+    bool report(const ControlFlowGraph& graph);
+};
+
+#endif // RANGES_H
@@ -0,0 +1,511 @@
+#include "rdparser.h"
+#include "frontend.h"
+#include "parser.tab.h"
+#include "parlexer.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+/* -------------------------------------------------
+ * 1) Precedência dos operadores binários (Pratt)
+ * ------------------------------------------------- */
+enum {
+    BP_NONE     = 0,
+    BP_ADITIVO  = 10,  // + -
+    BP_MULTIPL  = 20,  // * /
+    BP_RELACION = 30   // < > <= >= == != (não associativos)
+};
+
+static int infixBindingPower(int kind) {
+    switch (kind) {
+        case MAIS: case MENOS:
+            return BP_ADITIVO;
+        case VEZES: case DIV:
+            return BP_MULTIPL;
+        case MENOR: case MAIOR: case MENOR_IGUAL:
+        case MAIOR_IGUAL: case IGUAL_IGUAL: case DIFERENTE:
+            return BP_RELACION;
+        default:
+            return BP_NONE;
+    }
+}
+
+static BinaryOp binaryOp(int kind) {
+    switch (kind) {
+        case MAIS:        return OP_MAIS;
+        case MENOS:       return OP_MENOS;
+        case VEZES:       return OP_VEZES;
+        case DIV:         return OP_DIV;
+        case MENOR:       return OP_MENOR;
+        case MAIOR:       return OP_MAIOR;
+        case MENOR_IGUAL: return OP_MENOR_IGUAL;
+        case MAIOR_IGUAL: return OP_MAIOR_IGUAL;
+        case IGUAL_IGUAL: return OP_IGUAL_IGUAL;
+        default:          return OP_DIFERENTE;
+    }
+}
+
+/* -------------------------------------------------
+ * 2) Parser
+ * ------------------------------------------------- */
+
+/**
+ * @brief Estado do parser descendente recursivo. `ctx->lastToken` é
+ *        sempre o token de lookahead (o mesmo que o Bison teria lido),
+ *        e é nele que yyerror() reporta os erros.
+ */
+class RecursiveParser {
+public:
+    explicit RecursiveParser(ParseContext& c) : ctx(c), failed(false) {}
+
+    int parse();
+
+private:
+    ParseContext& ctx;
+    bool failed;
+
+    const Token& tok() const { return ctx.lastToken; }
+    void advance();
+    bool accept(int kind);
+    bool expect(int kind);
+    bool error();
+    bool recover();
+
+    bool identifier(SymbolId& out);
+    SymbolId literal() { return ctx.program->literals.intern(tok().text, tok().length); }
+
+    bool declaration();
+    bool block(int blockId, int opening);
+    bool statementList(bool nested);
+    bool nestedBlock(BlockId& out);
+    bool statement();
+    bool assignment();
+    bool ifStatement();
+    bool whileStatement();
+    bool expression(int minBp, Expr*& out);
+    bool primary(Expr*& out);
+    std::string exprString(const Expr* e) const { return exprText(e, *ctx.program); }
+
+    template <class Payload>
+    void addCommand(CmdType type, const Payload& payload, int line);
+};
+
+void RecursiveParser::advance() {
+    if (ctx.replay != NULL) {
+        ctx.lastToken = *ctx.replay;
+        if (ctx.replay + 1 < ctx.replayEnd) ctx.replay++; // o último é o fim da entrada
+    } else {
+        ctx.simd->next(ctx.lastToken);
+    }
+    const Token& t = ctx.lastToken;
+    if (t.kind == ERRO) {
+        ctx.frontendError = true;
+        ctx.diagnostics->report(DIAG_LEXICO, t.line, "Erro: caractere inválido %.*s",
+                                (int)t.length, t.text);
+    }
+    TRACE(TRACE_LEX, TRACE_DEBUG, "Token: %d, Valor: %.*s", t.kind, (int)t.length, t.text);
+}
+
+bool RecursiveParser::error() {
+    if (!failed) {
+        yyerror(&ctx, "syntax error");
+        failed = true;
+    }
+    return false;
+}
+
+/**
+ * @brief Recuperação das regras `error PONTO_VIRGULA` de parser.y:
+ *        descarta tokens até o próximo ';' (sem novas mensagens) e o
+ *        consome. No fim da entrada, ou com o limite de diagnósticos
+ *        atingido, a análise é abandonada (YYABORT).
+ */
+bool RecursiveParser::recover() {
+    while (tok().kind != PONTO_VIRGULA) {
+        if (tok().kind == 0) return false;
+        advance();
+    }
+    if (ctx.diagnostics->full()) return false;
+    advance();
+    failed = false;  // yyerrok
+    return true;
+}
+
+bool RecursiveParser::accept(int kind) {
+    if (tok().kind != kind) return false;
+    advance();
+    return true;
+}
+
+bool RecursiveParser::expect(int kind) {
+    return accept(kind) || error();
+}
+
+bool RecursiveParser::identifier(SymbolId& out) {
+    if (tok().kind != IDENTIFICADOR) return error();
+    out = ctx.program->names.intern(tok().text, tok().length);
+    advance();
+    return true;
+}
+
+template <class Payload>
+void RecursiveParser::addCommand(CmdType type, const Payload& payload, int line) {
+    if (CommandList* list = ctx.currentList()) {
+        list->emplace_back(type, payload, line);
+    }
+}
+
+/* program: declaration_list configBlock repitaBlock */
+int RecursiveParser::parse() {
+    advance();
+    while (tok().kind == VAR) {
+        if (!declaration() && !recover()) return 1;
+    }
+    if (!block(1, CONFIG)) return 1;
+    TRACE(TRACE_PARSE, TRACE_INFO, "Bloco de configuracao executado.");
+    if (!block(2, REPITA)) return 1;
+    TRACE(TRACE_PARSE, TRACE_INFO, "Programa validado corretamente.");
+    return tok().kind == 0 ? 0 : (error(), 1);
+}
+
+/* VAR type DOIS_PONTOS identifier_list PONTO_VIRGULA  (VAR error PONTO_VIRGULA) */
+bool RecursiveParser::declaration() {
+    int line = tok().line;
+    advance(); // VAR
+    VarType type;
+    switch (tok().kind) {
+        case TIPO_INTEIRO:  type = VAR_INTEIRO;  TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: inteiro"); break;
+        case TIPO_TEXTO:    type = VAR_TEXTO;    TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: texto"); break;
+        case TIPO_BOOLEANO: type = VAR_BOOLEANO; TRACE(TRACE_PARSE, TRACE_DEBUG, "Tipo: booleano"); break;
+        default:            return error();
+    }
+    advance();
+    if (!expect(DOIS_PONTOS)) return false;
+
+    // As declarações só entram no AST depois do ';', como no Bison
+    size_t first = ctx.program->declarations.size();
+    do {
+        VarDecl decl;
+        if (!identifier(decl.name)) {
+            ctx.program->declarations.resize(first);
+            return false;
+        }
+        decl.type = type;
+        decl.line = line;
+        ctx.program->declarations.push_back(decl);
+        TRACE(TRACE_PARSE, TRACE_INFO, "Declarando variavel: %s", ctx.program->names.cstr(decl.name));
+    } while (accept(VIRGULA));
+
+    if (!expect(PONTO_VIRGULA)) {
+        ctx.program->declarations.resize(first);
+        return false;
+    }
+    TRACE(TRACE_PARSE, TRACE_INFO, "Declaracao de variaveis realizada.");
+    return true;
+}
+
+/* CONFIG statement_list FIM  /  REPITA statement_list FIM */
+bool RecursiveParser::block(int blockId, int opening) {
+    if (!expect(opening)) return false;
+    ctx.currentBlock = blockId;
+    if (!statementList(false) || !expect(FIM)) return false;
+    ctx.currentBlock = 0;
+    return true;
+}
+
+static bool startsStatement(int kind) {
+    switch (kind) {
+        case IDENTIFICADOR: case CONFIGURAR: case CONFIGURAR_PWM: case AJUSTAR_PWM:
+        case CONECTAR_WIFI: case ESPERAR: case LIGAR: case DESLIGAR:
+        case ENVIAR_HTTP: case ESCREVER_SERIAL: case LER_SERIAL:
+        case SE: case ENQUANTO:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief statement_list, com a recuperação de `statement: error ';'`.
+ *
+ * Um comando com erro é descartado até o ';' e a lista continua. A lista
+ * termina em `fim` (e, num sub-bloco, também em `senão`; se ele não
+ * couber ali, quem reclama é o se/enquanto). Qualquer outro token é erro
+ * da própria lista: nos estados com a ação `error` o Bison não usa
+ * redução padrão, então o erro é detectado e recuperado aqui.
+ */
+bool RecursiveParser::statementList(bool nested) {
+    for (;;) {
+        int kind = tok().kind;
+        if (startsStatement(kind)) {
+            if (statement()) continue;
+        } else if (kind == FIM || (nested && kind == SENAO)) {
+            return true;
+        } else {
+            error();
+        }
+        if (!recover()) return false;
+    }
+}
+
+/* Corpo de se/senão/enquanto: statement_list num sub-bloco novo */
+bool RecursiveParser::nestedBlock(BlockId& out) {
+    out = ctx.openBlock();
+    bool ok = statementList(true);
+    ctx.closeBlock();  // mesmo abandonando: como o %destructor de parser.y
+    return ok;
+}
+
+bool RecursiveParser::statement() {
+    int line = tok().line;  // @1.first_line de parser.y
+    switch (tok().kind) {
+        case IDENTIFICADOR:
+            return assignment();
+
+        case SE:
+            return ifStatement();
+
+        case ENQUANTO:
+            return whileStatement();
+
+        case CONFIGURAR: {
+            ConfigPinCmd p;
+            advance();
+            if (!identifier(p.pin) || !expect(COMO)) return false;
+            if (tok().kind != DIRECAO) return error();
+            SymbolId mode = literal();
+            p.mode = pinModeFromText(ctx.program->literals.name(mode));
+            advance();
+            if (!expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_CONFIG_PIN, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Configurando pino: %s como %s.",
+                  ctx.program->names.cstr(p.pin), ctx.program->literals.cstr(mode));
+            return true;
+        }
+
+        case CONFIGURAR_PWM: {
+            ConfigPwmCmd p;
+            advance();
+            if (!identifier(p.pin) || !expect(COM) || !expect(FREQUENCIA)) return false;
+            if (tok().kind != NUMERO) return error();
+            p.freq = tok().intval;
+            advance();
+            if (!expect(RESOLUCAO)) return false;
+            if (tok().kind != NUMERO) return error();
+            p.resol = tok().intval;
+            advance();
+            if (!expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_CONFIG_PWM, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Configurando PWM no pino: %s com frequencia: %d e resolucao: %d",
+                  ctx.program->names.cstr(p.pin), p.freq, p.resol);
+            return true;
+        }
+
+        case AJUSTAR_PWM: {
+            PwmAdjustCmd p;
+            p.duty = DUTY_UNCHECKED;
+            advance();
+            if (!identifier(p.pin) || !expect(COM) || !expect(VALOR)) return false;
+            if (!expression(BP_NONE, p.value) || !expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_PWM_ADJUST, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Ajustando PWM no pino: %s com valor: %s",
+                  ctx.program->names.cstr(p.pin), exprString(p.value).c_str());
+            return true;
+        }
+
+        case CONECTAR_WIFI: {
+            WifiCmd p;
+            advance();
+            if (!identifier(p.ssid) || !identifier(p.password) || !expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_WIFI_CONNECT, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Conectando WiFi: SSID = %s, SENHA = %s",
+                  ctx.program->names.cstr(p.ssid), ctx.program->names.cstr(p.password));
+            return true;
+        }
+
+        case ESPERAR: {
+            WaitCmd p;
+            advance();
+            if (!expression(BP_NONE, p.time) || !expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_WAIT, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Esperando: %s ms", exprString(p.time).c_str());
+            return true;
+        }
+
+        case LIGAR:
+        case DESLIGAR: {
+            DigitalCmd p;
+            CmdType type = tok().kind == LIGAR ? CMD_LIGAR : CMD_DESLIGAR;
+            advance();
+            if (!identifier(p.pin) || !expect(PONTO_VIRGULA)) return false;
+            addCommand(type, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Comando digital: %s %s",
+                  type == CMD_LIGAR ? "LIGAR" : "DESLIGAR", ctx.program->names.cstr(p.pin));
+            return true;
+        }
+
+        case ENVIAR_HTTP: {
+            HttpCmd p;
+            advance();
+            if (tok().kind != STRING_LIT) return error();
+            p.url = literal();
+            advance();
+            if (tok().kind != STRING_LIT) return error();
+            p.data = literal();
+            advance();
+            if (!expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_ENVIAR_HTTP, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Enviando HTTP: URL = %s, DADOS = %s",
+                  ctx.program->literals.cstr(p.url), ctx.program->literals.cstr(p.data));
+            return true;
+        }
+
+        case ESCREVER_SERIAL: {
+            SerialCmd p;
+            advance();
+            if (tok().kind != STRING_LIT) return error();
+            p.msg = literal();
+            advance();
+            if (!expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_ESCREVER_SERIAL, p, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Escrevendo na Serial: %s", ctx.program->literals.cstr(p.msg));
+            return true;
+        }
+
+        case LER_SERIAL:
+            advance();
+            if (!expect(PONTO_VIRGULA)) return false;
+            addCommand(CMD_LER_SERIAL, SerialCmd{NO_SYMBOL}, line);
+            TRACE(TRACE_PARSE, TRACE_INFO, "Lendo da Serial");
+            return true;
+
+        default:
+            return error();
+    }
+}
+
+/* IDENTIFICADOR IGUAL (expression | lerDigital ID | lerAnalogico ID) PONTO_VIRGULA */
+bool RecursiveParser::assignment() {
+    int line = tok().line;
+    SymbolId var;
+    if (!identifier(var) || !expect(IGUAL)) return false;
+
+    if (tok().kind == LER_DIGITAL || tok().kind == LER_ANALOGICO) {
+        ReadPinCmd p;
+        CmdType type = tok().kind == LER_DIGITAL ? CMD_LER_DIGITAL : CMD_LER_ANALOGICO;
+        p.var = var;
+        advance();
+        if (!identifier(p.pin) || !expect(PONTO_VIRGULA)) return false;
+        addCommand(type, p, line);
+        return true;
+    }
+
+    AssignCmd p;
+    p.var = var;
+    if (!expression(BP_NONE, p.value) || !expect(PONTO_VIRGULA)) return false;
+    addCommand(CMD_ASSIGN, p, line);
+    TRACE(TRACE_PARSE, TRACE_INFO, "Atribuindo: %s = %s",
+          ctx.program->names.cstr(p.var), exprString(p.value).c_str());
+    return true;
+}
+
+/* SE expression ENTAO statement_list [SENAO statement_list] FIM */
+bool RecursiveParser::ifStatement() {
+    CondCmd p;
+    p.elseBody = NO_BLOCK;
+    int line = tok().line;
+    advance(); // SE
+    if (!expression(BP_NONE, p.condition) || !expect(ENTAO)) return false;
+    if (!nestedBlock(p.body)) return false;
+    if (accept(SENAO)) {
+        if (!nestedBlock(p.elseBody)) return false;
+        TRACE(TRACE_PARSE, TRACE_INFO, "Bloco SENAO executado.");
+    }
+    if (!expect(FIM)) return false;
+    addCommand(CMD_IF, p, line);
+    TRACE(TRACE_PARSE, TRACE_INFO, "Condicional SE executada com condicao: %s", exprString(p.condition).c_str());
+    return true;
+}
+
+/* ENQUANTO expression statement_list FIM */
+bool RecursiveParser::whileStatement() {
+    CondCmd p;
+    p.elseBody = NO_BLOCK;
+    int line = tok().line;
+    advance(); // ENQUANTO
+    if (!expression(BP_NONE, p.condition)) return false;
+    if (!nestedBlock(p.body) || !expect(FIM)) return false;
+    addCommand(CMD_WHILE, p, line);
+    TRACE(TRACE_PARSE, TRACE_INFO, "Estrutura ENQUANTO executada com condicao: %s", exprString(p.condition).c_str());
+    return true;
+}
+
+/**
+ * @brief Pratt: consome operadores com precedência maior que `minBp`.
+ *        Monta a mesma árvore que as ações de parser.y.
+ */
+bool RecursiveParser::expression(int minBp, Expr*& out) {
+    if (!primary(out)) return false;
+
+    int previousBp = BP_NONE;
+    for (;;) {
+        int op = tok().kind;
+        int bp = infixBindingPower(op);
+        if (bp == BP_NONE || bp <= minBp) break;
+        // a < b < c: os relacionais não associam (%nonassoc)
+        if (bp == BP_RELACION && previousBp == BP_RELACION) return error();
+        advance();
+
+        Expr* rhs;
+        if (!expression(bp, rhs)) return false;
+        out = ctx.program->newBinary(binaryOp(op), out, rhs);
+        previousBp = bp;
+    }
+    return true;
+}
+
+bool RecursiveParser::primary(Expr*& out) {
+    switch (tok().kind) {
+        case NUMERO:
+            out = ctx.program->newNumber(tok().intval);
+            break;
+        case IDENTIFICADOR:
+            out = ctx.program->newIdent(ctx.program->names.intern(tok().text, tok().length));
+            break;
+        case STRING_LIT:
+            out = ctx.program->newString(literal());
+            break;
+        case '(':
+            advance();
+            if (!expression(BP_NONE, out)) return false;
+            if (tok().kind != ')') return error();
+            out = ctx.program->newParen(out);
+            break;
+        default:
+            return error();
+    }
+    advance();
+    return true;
+}
+
+/* -------------------------------------------------
+ * 3) Ponto de entrada
+ * ------------------------------------------------- */
+int parseProgramRD(SourceBuffer& source, ASTProgram& program, DiagnosticList& diagnostics,
+                   unsigned lexThreads) {
+    ParseContext ctx(&program, &diagnostics);
+    RecursiveParser parser(ctx);
+
+    if (lexThreads > 1) {
+        std::vector<Token> tokens;
+        lexParallel(source.data, source.data + source.size, lexThreads, tokens);
+        ctx.replay = tokens.data();
+        ctx.replayEnd = tokens.data() + tokens.size();
+        return parser.parse();
+    }
+
+    SimdLexer simd(source.data, source.data + source.size);
+    ctx.simd = &simd;
+    return parser.parse();
+}
@@ -0,0 +1,35 @@
+#ifndef RDPARSER_H
+#define RDPARSER_H
+
+#include "ast.h"
+#include "source.h"
+#include "diagnostics.h"
+
+/**
+ * @brief Parser descendente recursivo, alternativo ao parser.y.
+ *
+ * Aceita exatamente a mesma linguagem e monta o mesmo ASTProgram, na
+ * mesma ordem (inclusive a numeração dos sub-blocos de se/senão/enquanto,
+ * abertos na mesma ordem que no Bison). As expressões usam
+ * Pratt parsing com as precedências de parser.y:
+ *
+ *     + -        10, associativos à esquerda
+ *     * /        20, associativos à esquerda
+ *     < > <= >= == !=   30, não associativos
+ *
+ * Os tokens vêm do SimdLexer (ou do léxico paralelo, com lexThreads > 1)
+ * e são lidos por valor, sem alocação; strings e direções são copiadas
+ * direto do buffer para o AST, e as expressões viram nós do ASTProgram.
+ *
+ * Erros de sintaxe são registrados em `diagnostics` no mesmo token e com
+ * a mesma mensagem que o Bison ("syntax error"), e a recuperação imita
+ * as regras `error` de parser.y: o comando (ou a declaração) com erro é
+ * descartado até o próximo ';' e a análise continua.
+ *
+ * @return 0 se o programa foi lido até o fim (mesmo com erros
+ *         recuperados), 1 se a análise foi abandonada.
+ */
+int parseProgramRD(SourceBuffer& source, ASTProgram& program, DiagnosticList& diagnostics,
+                   unsigned lexThreads = 1);
+
+#endif // RDPARSER_H
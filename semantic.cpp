@@ -1,303 +1,479 @@
 #include "semantic.h"
-#include <iostream>
-#include <unordered_map>
+#include "ledc.h"
+#include "pinflow.h"
+#include "trace.h"
+#include <stdarg.h>
+#include <stdio.h>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 /**
- * @brief Estrutura para manter informações de cada variável
- *        no contexto da análise semântica (tabela de símbolos).
- * 
- * Você pode simplesmente usar VarDecl, mas às vezes 
- * há dados extras. Aqui está um exemplo simples.
+ * @brief Estado de uma análise semântica. Fica na pilha de
+ *        semanticAnalysis(), então análises de programas diferentes
+ *        podem rodar em paralelo.
  */
-struct SymbolInfo {
-    VarType type;
-    bool isPin;
-    bool isPWM;
-    std::string pinMode; // "saida" ou "entrada"
+struct SemanticContext {
+    // Tabela de símbolos do programa (ASTProgram::symbols), preenchida aqui.
+    // Se a variável é pino (modo, PWM) depende do caminho: isso fica em `pins`
+    SymbolTable* symbols;
 
-    SymbolInfo() : type(VAR_UNDEFINED), isPin(false), isPWM(false) {}
+    // Nomes do programa em análise (para mensagens de erro)
+    const StringInterner* names;
+
+    // Onde os erros são registrados
+    DiagnosticList* diagnostics;
+
+    // Espinha esquerda das expressões em verificação (checkExpr)
+    std::vector<const Expr*> spine;
+
+    // Estado dos pinos no comando em verificação, na primeira vez que a
+    // execução chega a ele (sem a aresta de volta de enquanto/repita).
+    // Um erro só é acusado quando o pino está errado em todos os caminhos.
+    PinSlots pinSlots;
+    PinStates pins;
+
+    // Linha do comando (ou da declaração) em verificação, para os erros
+    int line;
+
+    PinState pin(SymbolId id) const { return pins.get(pinSlots.find(id)); }
+    void setPin(SymbolId id, unsigned mask, unsigned value) {
+        uint32_t slot = pinSlots.slot(id);
+        pins.set(slot, pinSet(pins.get(slot), mask, value));
+    }
+
+    SemanticContext(SymbolTable* s, const StringInterner* n, DiagnosticList* d)
+        : symbols(s), names(n), diagnostics(d), line(0) {}
+
+    const char* nameOf(SymbolId id) const { return names->cstr(id); }
+
+    /**
+     * @brief Registra um erro semântico na linha em verificação.
+     * @return false, para que a verificação possa fazer "return sc.error(...)".
+     */
+    bool error(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
 };
 
-/**
- * @brief Tabela de símbolos: nome da var -> informações
- */
-static std::unordered_map<std::string, SymbolInfo> symbolTable;
+bool SemanticContext::error(const char* fmt, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    diagnostics->report(DIAG_SEMANTICO, line, "%s (linha %d)", buffer, line);
+    return false;
+}
 
 /**
  * @brief Funções auxiliares de verificação de cada tipo de comando
  */
-static void checkCommand(const Command& cmd);
-static void checkAssign(const Command& cmd);
-static void checkConfigPin(const Command& cmd);
-static void checkConfigPwm(const Command& cmd);
-static void checkPwmAdjust(const Command& cmd);
-static void checkDigital(const Command& cmd);
-static void checkLerDigital(const Command& cmd);
-static void checkLerAnalogico(const Command& cmd);
-VarType inferExpressionType(const std::string &expr);
+static bool checkGraph(SemanticContext& sc, const ControlFlowGraph& graph);
+static bool checkRegion(SemanticContext& sc, const ControlFlowGraph& graph,
+                        BasicBlockId from, BasicBlockId stop);
+static bool checkCommand(SemanticContext& sc, const Command& cmd);
+static bool checkCondition(SemanticContext& sc, const BasicBlock& block);
+static bool checkAssign(SemanticContext& sc, const AssignCmd& cmd);
+static bool checkConfigPin(SemanticContext& sc, const ConfigPinCmd& cmd);
+static bool checkConfigPwm(SemanticContext& sc, const ConfigPwmCmd& cmd);
+static bool checkPwmAdjust(SemanticContext& sc, const PwmAdjustCmd& cmd);
+static bool checkDigital(SemanticContext& sc, const DigitalCmd& cmd);
+static bool checkLerDigital(SemanticContext& sc, const ReadPinCmd& cmd);
+static bool checkLerAnalogico(SemanticContext& sc, const ReadPinCmd& cmd);
+static bool checkWait(SemanticContext& sc, const WaitCmd& cmd);
+static VarType checkExpr(SemanticContext& sc, const Expr* expr, bool& ok);
 
 /**
  * @brief Função principal de Análise Semântica
  */
-void semanticAnalysis(ASTProgram& program) {
-    symbolTable.clear();
+bool semanticAnalysis(ASTProgram& program, const ProgramCfg& cfg, DiagnosticList& diagnostics) {
+    SemanticAnalyzer analyzer(program, diagnostics);
 
     // 1) Registrar cada declaração de variável na tabela de símbolos
+    bool ok = analyzer.declarations();
+
+    // 2) Percorrer os grafos de "config" e "repita" checando comandos;
+    //    um erro não interrompe a análise, para que todos sejam relatados
+    ok = analyzer.graph(cfg.setup) && ok;
+    ok = analyzer.graph(cfg.loop) && ok;
+
+    // 3) Canais e temporizadores do PWM
+    ok = analyzer.finish() && ok;
+    return ok;
+}
+
+SemanticAnalyzer::SemanticAnalyzer(ASTProgram& p, DiagnosticList& diagnostics)
+    : program(p), sc(new SemanticContext(&p.symbols, &p.names, &diagnostics)) {}
+
+SemanticAnalyzer::~SemanticAnalyzer() {}
+
+bool SemanticAnalyzer::declarations() {
+    bool ok = true;
+    sc->symbols->clear();
     for (auto &decl : program.declarations) {
-        // Verifica se a variável já existe
-        if (symbolTable.find(decl.name) != symbolTable.end()) {
-            std::cerr << "Erro semântico: Variável '" << decl.name 
-                      << "' declarada mais de uma vez.\n";
-            exit(1); // ou trate de modo a continuar procurando erros
+        // Verifica se a variável já existe (vale a primeira declaração)
+        sc->line = decl.line;
+        if (sc->symbols->declared(decl.name)) {
+            ok = sc->error("Erro semântico: Variável '%s' declarada mais de uma vez.",
+                           sc->nameOf(decl.name));
+            continue;
         }
 
-        // Cria SymbolInfo com base em VarDecl
-        SymbolInfo info;
-        info.type = decl.type;       // ex. VAR_INTEIRO, VAR_TEXTO, etc.
-        info.isPin = decl.isPin;     // false inicialmente
-        info.isPWM = decl.isPWM;     // false inicialmente
-        info.pinMode = decl.pinMode; // ""
+        // Registra tipo e modo de pino (ex. VAR_INTEIRO, PINO_NENHUM)
+        sc->symbols->declare(decl.name, decl.type, decl.pinMode);
 
-        symbolTable[decl.name] = info;
+        // pinMode/isPWM (vazios inicialmente) viram o estado inicial do pino
+        if (decl.pinMode != PINO_NENHUM) {
+            sc->setPin(decl.name, PIN_MODE_MASK, pinModeBit(decl.pinMode));
+        }
+        if (decl.isPWM) {
+            sc->setPin(decl.name, PIN_PWM_MASK, PIN_PWM_YES);
+        }
+        TRACE(TRACE_SEMANTIC, TRACE_DEBUG, "Simbolo registrado: %s", sc->nameOf(decl.name));
     }
+    return ok;
+}
 
-    // 2) Percorrer blocos "config" e "repita" checando comandos
-    for (auto &cmd : program.configCommands) {
-        checkCommand(cmd);
-    }
+bool SemanticAnalyzer::graph(const ControlFlowGraph& graph) {
+    return checkGraph(*sc, graph);
+}
+
+bool SemanticAnalyzer::finish() {
+    return allocateLedc(*sc->symbols, *sc->names, *sc->diagnostics);
+}
+
+/**
+ * @brief Verifica o grafo inteiro, continuando depois de um erro; só para
+ *        antes do fim quando o limite de diagnósticos é atingido.
+ */
+static bool checkGraph(SemanticContext& sc, const ControlFlowGraph& graph) {
+    return checkRegion(sc, graph, graph.entry, NO_BASIC_BLOCK);
+}
 
-    for (auto &cmd : program.repitaCommands) {
-        checkCommand(cmd);
+/**
+ * @brief Visita os blocos de `from` até `stop` na ordem do fonte (a mesma
+ *        ordem de índice), levando o estado dos pinos por cada caminho:
+ *        depois de um "se" valem os dois ramos; depois de um "enquanto",
+ *        "não entrou" e "deu uma volta".
+ */
+static bool checkRegion(SemanticContext& sc, const ControlFlowGraph& graph,
+                        BasicBlockId from, BasicBlockId stop) {
+    bool ok = true;
+    BasicBlockId id = from;
+    while (id != stop && !sc.diagnostics->full()) {
+        const BasicBlock& block = graph.blocks[id];
+        for (const Command* cmd = block.begin; cmd != block.end; ++cmd) {
+            ok = checkCommand(sc, *cmd) && ok;
+        }
+        if (block.term == TERM_RETURN) {
+            break;
+        }
+        if (block.term == TERM_JUMP) {
+            id = block.next;
+            continue;
+        }
+
+        ok = checkCondition(sc, block) && ok;
+        PinStates other = sc.pins;
+        if (block.origin->cmdType == CMD_WHILE) {
+            ok = checkRegion(sc, graph, block.next, id) && ok;
+        } else {
+            ok = checkRegion(sc, graph, block.next, block.join) && ok;
+            if (block.other != block.join) {
+                std::swap(sc.pins, other);
+                ok = checkRegion(sc, graph, block.other, block.join) && ok;
+            }
+        }
+        sc.pins.join(other);
+        id = block.join;
     }
+    return ok;
+}
 
-    std::cout << "Análise semântica concluída sem erros!\n";
+/**
+ * @brief Verifica a condição de um "se"/"enquanto": não pode ser texto.
+ */
+static bool checkCondition(SemanticContext& sc, const BasicBlock& block) {
+    bool ok = true;
+    sc.line = block.origin->line;
+    if (checkExpr(sc, block.condition, ok) == VAR_TEXTO) {
+        return sc.error("Erro semântico: condição de '%s' não pode ser texto.",
+                        block.origin->cmdType == CMD_WHILE ? "enquanto" : "se");
+    }
+    return ok;
 }
 
 /**
  * @brief Decide qual verificação chamar, dependendo do cmdType
  */
-static void checkCommand(const Command& cmd) {
+static bool checkCommand(SemanticContext& sc, const Command& cmd) {
+    TRACE(TRACE_SEMANTIC, TRACE_DEBUG, "Verificando comando tipo %d", (int)cmd.cmdType);
+    sc.line = cmd.line;
     switch(cmd.cmdType) {
         case CMD_ASSIGN:
-            checkAssign(cmd);
-            break;
+            return checkAssign(sc, cmd.assign);
         case CMD_CONFIG_PIN:
-            checkConfigPin(cmd);
-            break;
+            return checkConfigPin(sc, cmd.configPin);
         case CMD_CONFIG_PWM:
-            checkConfigPwm(cmd);
-            break;
+            return checkConfigPwm(sc, cmd.configPwm);
         case CMD_PWM_ADJUST:
-            checkPwmAdjust(cmd);
-            break;
+            return checkPwmAdjust(sc, cmd.pwmAdjust);
         case CMD_LIGAR:
         case CMD_DESLIGAR:
-            checkDigital(cmd);
-            break;
+            return checkDigital(sc, cmd.digital);
         case CMD_LER_DIGITAL:
-            checkLerDigital(cmd);
-            break;
+            return checkLerDigital(sc, cmd.readPin);
         case CMD_LER_ANALOGICO:
-            checkLerAnalogico(cmd);
-            break;
+            return checkLerAnalogico(sc, cmd.readPin);
+        case CMD_WAIT:
+            return checkWait(sc, cmd.wait);
         // Se quiser WiFi, HTTP, Serial etc. com checagens adicionais
         // case CMD_WIFI_CONNECT: ...
         // case CMD_ENVIAR_HTTP:  ...
         // etc.
         default:
             // Por enquanto, sem checagem específica
-            break;
+            return true;
     }
 }
 
 /**
  * @brief Verifica atribuição: "ledPin = 2;"
- *        - Se varName existe na tabela
+ *        - Se a variável existe na tabela
  *        - Se tipo é compatível
  */
-static void checkAssign(const Command& cmd) {
-    auto it = symbolTable.find(cmd.varName);
-    if (it == symbolTable.end()) {
-        std::cerr << "Erro semântico: Variável '" 
-                  << cmd.varName << "' não foi declarada.\n";
-        exit(1);
+static bool checkAssign(SemanticContext& sc, const AssignCmd& cmd) {
+    if (!sc.symbols->declared(cmd.var)) {
+        return sc.error("Erro semântico: Variável '%s' não foi declarada.", sc.nameOf(cmd.var));
     }
 
-    VarType varType = it->second.type;  // ex. VAR_INTEIRO
-    // Aqui é a “string” da expressão que o parser guardou
-    VarType exprT = inferExpressionType(cmd.expr); // Ex.: "ledPin+128"
+    VarType varType = sc.symbols->type(cmd.var);  // ex. VAR_INTEIRO
+    // Aqui é a árvore da expressão que o parser montou
+    bool ok = true;
+    VarType exprT = checkExpr(sc, cmd.value, ok); // Ex.: ledPin + 128
 
-    // Se varType é inteiro e exprT for VAR_TEXTO => erro
-    // Se varType é texto e exprT for VAR_INTEIRO => erro, etc.
-    if (varType==VAR_INTEIRO && exprT==VAR_TEXTO) {
-        std::cerr << "Erro semântico: atribuição de texto em variável inteira '"
-                  << cmd.varName << "'\n";
-        exit(1);
+    // Texto só combina com texto; inteiro e booleano se convertem um no
+    // outro (como em C++). Expressão com erro (VAR_UNDEFINED) já foi acusada.
+    if (exprT == VAR_UNDEFINED || (varType == VAR_TEXTO) == (exprT == VAR_TEXTO)) {
+        return ok;
+    }
+    if (varType==VAR_INTEIRO) {
+        return sc.error("Erro semântico: atribuição de texto em variável inteira '%s'",
+                        sc.nameOf(cmd.var));
     }
-    if (varType==VAR_TEXTO && exprT==VAR_INTEIRO) {
-        std::cerr << "Erro semântico: atribuição de inteiro em variável texto '"
-                  << cmd.varName << "'\n";
-        exit(1);
+    if (varType==VAR_BOOLEANO) {
+        return sc.error("Erro semântico: atribuição de texto em variável booleana '%s'",
+                        sc.nameOf(cmd.var));
     }
-    // etc.
+    return sc.error("Erro semântico: atribuição de %s em variável texto '%s'",
+                    exprT == VAR_BOOLEANO ? "booleano" : "inteiro", sc.nameOf(cmd.var));
 }
 
 /**
  * @brief Verifica se "configurar ledPin como saida"
  *        - Se ledPin foi declarado
- *        - Marca isPin=true; pinMode="saida"
+ *        - Daqui em diante ledPin é pino, no modo pedido
  */
-static void checkConfigPin(const Command& cmd) {
-    auto it = symbolTable.find(cmd.pin);
-    if (it == symbolTable.end()) {
-        std::cerr << "Erro semântico: Variável '" 
-                  << cmd.pin << "' não foi declarada.\n";
-        exit(1);
+static bool checkConfigPin(SemanticContext& sc, const ConfigPinCmd& cmd) {
+    if (!sc.symbols->declared(cmd.pin)) {
+        return sc.error("Erro semântico: Variável '%s' não foi declarada.", sc.nameOf(cmd.pin));
     }
-    // Marca como pino
-    it->second.isPin = true;
-    it->second.pinMode = cmd.pinMode; // "saida" ou "entrada"
+    // Marca como pino ("saida" ou "entrada")
+    sc.setPin(cmd.pin, PIN_MODE_MASK, pinModeBit(cmd.mode));
+    return true;
 }
 
 /**
  * @brief Verifica se "configurarPWM ledPin com freq e resol"
  *        - Se ledPin foi declarado
- *        - Marca isPWM=true
+ *        - Se o LEDC gera essa frequência com essa resolução
+ *        - Daqui em diante ledPin tem PWM
  */
-static void checkConfigPwm(const Command& cmd) {
-    auto it = symbolTable.find(cmd.pin);
-    if (it == symbolTable.end()) {
-        std::cerr << "Erro semântico: Variável '"
-                  << cmd.pin << "' não foi declarada.\n";
-        exit(1);
+static bool checkConfigPwm(SemanticContext& sc, const ConfigPwmCmd& cmd) {
+    if (!sc.symbols->declared(cmd.pin)) {
+        return sc.error("Erro semântico: Variável '%s' não foi declarada.", sc.nameOf(cmd.pin));
+    }
+    bool ok = true;
+    if (!ledcTimingOk(cmd.freq, cmd.resol)) {
+        ok = sc.error("Erro semântico: PWM de '%s' com %d Hz e %d bits não existe no ESP32 "
+                      "(resolução de 1 a %d bits e frequência * 2^resolução até %lld Hz).",
+                      sc.nameOf(cmd.pin), cmd.freq, cmd.resol, LEDC_MAX_RESOL,
+                      (long long)LEDC_CLOCK_HZ);
     }
-    it->second.isPWM = true;
+    // Mesmo com erro o pino tem PWM daqui em diante (sem erros em cascata)
+    sc.setPin(cmd.pin, PIN_PWM_MASK, PIN_PWM_YES);
+    // O primeiro configurarPWM do pino define o canal (na ordem do fonte)
+    sc.symbols->addPwm(cmd.pin, cmd.freq, cmd.resol, sc.line);
+    return ok;
 }
 
 /**
  * @brief Verifica se "ajustarPWM ledPin com valor X"
  *        - Se ledPin existe
- *        - Se isPWM=true antes de usar
+ *        - Se há PWM em ledPin em algum caminho até aqui
+ *        - Se X não é texto
  */
-static void checkPwmAdjust(const Command& cmd) {
-    auto it = symbolTable.find(cmd.pin);
-    if (it == symbolTable.end()) {
-        std::cerr << "Erro semântico: Variável '" 
-                  << cmd.pin << "' não foi declarada.\n";
-        exit(1);
+static bool checkPwmAdjust(SemanticContext& sc, const PwmAdjustCmd& cmd) {
+    bool ok = true;
+    if (!sc.symbols->declared(cmd.pin)) {
+        ok = sc.error("Erro semântico: Variável '%s' não foi declarada.", sc.nameOf(cmd.pin));
+    } else if (!(sc.pin(cmd.pin) & PIN_PWM_YES)) {
+        ok = sc.error("Erro semântico: Pino '%s' não foi configurado como PWM antes de usar 'ajustarPWM'.",
+                      sc.nameOf(cmd.pin));
     }
-    if (!it->second.isPWM) {
-        std::cerr << "Erro semântico: Pino '"
-                  << cmd.pin << "' não foi configurado como PWM antes de usar 'ajustarPWM'.\n";
-        exit(1);
+    // O valor é verificado mesmo com erro no pino
+    if (checkExpr(sc, cmd.value, ok) == VAR_TEXTO) {
+        return sc.error("Erro semântico: valor de 'ajustarPWM' não pode ser texto.");
     }
+    return ok;
+}
+
+/**
+ * @brief Verifica "esperar 1000;": o tempo não pode ser texto.
+ */
+static bool checkWait(SemanticContext& sc, const WaitCmd& cmd) {
+    bool ok = true;
+    if (checkExpr(sc, cmd.time, ok) == VAR_TEXTO) {
+        return sc.error("Erro semântico: tempo de 'esperar' não pode ser texto.");
+    }
+    return ok;
 }
 
 /**
  * @brief Verifica "ligar ledPin;" ou "desligar ledPin;"
  *        - Se ledPin existe
- *        - Se isPin=true e pinMode="saida"
+ *        - Se ledPin pode estar configurado como "saida" aqui
  */
-static void checkDigital(const Command& cmd) {
-    auto it = symbolTable.find(cmd.digitalPin);
-    if (it == symbolTable.end()) {
-        std::cerr << "Erro semântico: Variável '" 
-                  << cmd.digitalPin << "' não foi declarada.\n";
-        exit(1);
+static bool checkDigital(SemanticContext& sc, const DigitalCmd& cmd) {
+    if (!sc.symbols->declared(cmd.pin)) {
+        return sc.error("Erro semântico: Variável '%s' não foi declarada.", sc.nameOf(cmd.pin));
     }
-    if (!it->second.isPin) {
-        std::cerr << "Erro semântico: '" << cmd.digitalPin
-                  << "' não foi configurado como pino.\n";
-        exit(1);
+    PinState mode = sc.pin(cmd.pin) & PIN_MODE_MASK;
+    if (mode == PIN_MODE_NONE) {
+        return sc.error("Erro semântico: '%s' não foi configurado como pino.", sc.nameOf(cmd.pin));
     }
-    if (it->second.pinMode != "saida") {
-        std::cerr << "Erro semântico: '" << cmd.digitalPin 
-                  << "' não está como 'saida'.\n";
-        exit(1);
+    if (!(mode & PIN_MODE_SAIDA)) {
+        return sc.error("Erro semântico: '%s' não está como 'saida'.", sc.nameOf(cmd.pin));
     }
+    return true;
 }
 
-static void checkLerDigital(const Command &cmd) {
-    // 1) Verifique se varName existe:
-    auto itVar = symbolTable.find(cmd.varName);
-    if (itVar == symbolTable.end()) {
-        std::cerr << "Erro semântico: variável de destino '" 
-                  << cmd.varName << "' não foi declarada.\n";
-        exit(1);
+static bool checkLerDigital(SemanticContext& sc, const ReadPinCmd& cmd) {
+    // 1) Verifique se a variável de destino existe:
+    if (!sc.symbols->declared(cmd.var)) {
+        return sc.error("Erro semântico: variável de destino '%s' não foi declarada.",
+                        sc.nameOf(cmd.var));
     }
-    // 2) Verifique se pin existe e está configurado como entrada:
-    auto itPin = symbolTable.find(cmd.pin);
-    if (itPin == symbolTable.end()) {
-        std::cerr << "Erro semântico: pino '" 
-                  << cmd.pin << "' não foi declarado.\n";
-        exit(1);
+    // 2) Verifique se pin existe e pode estar configurado como entrada:
+    if (!sc.symbols->declared(cmd.pin)) {
+        return sc.error("Erro semântico: pino '%s' não foi declarado.", sc.nameOf(cmd.pin));
     }
-    if (!itPin->second.isPin || itPin->second.pinMode != "entrada") {
-        std::cerr << "Erro semântico: 'lerDigital' requer pino configurado como entrada.\n";
-        exit(1);
+    if (!(sc.pin(cmd.pin) & PIN_MODE_ENTRADA)) {
+        return sc.error("Erro semântico: 'lerDigital' requer pino configurado como entrada.");
     }
+    return true;
 }
 
-static void checkLerAnalogico(const Command &cmd) {
+static bool checkLerAnalogico(SemanticContext& sc, const ReadPinCmd& cmd) {
     // Mesmo processo, mas se você tiver "entradaAnalog" ou algo do tipo:
-    auto itVar = symbolTable.find(cmd.varName);
-    if (itVar == symbolTable.end()) {
-        std::cerr << "Erro semântico: variável de destino '" 
-                  << cmd.varName << "' não foi declarada.\n";
-        exit(1);
+    if (!sc.symbols->declared(cmd.var)) {
+        return sc.error("Erro semântico: variável de destino '%s' não foi declarada.",
+                        sc.nameOf(cmd.var));
     }
-    auto itPin = symbolTable.find(cmd.pin);
-    if (itPin == symbolTable.end()) {
-        std::cerr << "Erro semântico: pino '" 
-                  << cmd.pin << "' não foi declarado.\n";
-        exit(1);
+    if (!sc.symbols->declared(cmd.pin)) {
+        return sc.error("Erro semântico: pino '%s' não foi declarado.", sc.nameOf(cmd.pin));
     }
     // Se sua DSL exige "entradaAnalog" ou "entrada" normal, verifique aqui.
-    if (!itPin->second.isPin /* ou itPin->second.pinMode != "entradaAnalog" */ ) {
-        std::cerr << "Erro semântico: 'lerAnalogico' requer pino configurado como entrada analog.\n";
-        exit(1);
+    if ((sc.pin(cmd.pin) & PIN_MODE_MASK) == PIN_MODE_NONE) {
+        return sc.error("Erro semântico: 'lerAnalogico' requer pino configurado como entrada analog.");
     }
+    return true;
 }
 
-// Retorna VAR_INTEIRO, VAR_TEXTO, ou VAR_UNDEFINED se não conseguir deduzir
-VarType inferExpressionType(const std::string &expr) {
-    // 1) Se começa com aspas => texto
-    if (!expr.empty() && expr[0] == '"') {
-        // ex.: "\"Olá\""
-        return VAR_TEXTO;
+/**
+ * @brief Tipo de uma folha (número, texto ou identificador).
+ */
+static VarType leafType(SemanticContext& sc, const Expr* expr, bool& ok) {
+    switch (expr->kind) {
+        case EXPR_NUMERO:
+            return VAR_INTEIRO;
+        case EXPR_TEXTO:
+            return VAR_TEXTO;
+        case EXPR_IDENT: {
+            VarType type = sc.symbols->type(expr->symbol);
+            if (type == VAR_UNDEFINED) {
+                ok = sc.error("Erro semântico: Variável '%s' não foi declarada.",
+                              sc.nameOf(expr->symbol));
+            }
+            return type;
+        }
+        default:
+            return VAR_UNDEFINED;
     }
+}
 
-    // 2) Se expressão exata está no symbolTable => retorne o type
-    // (significa que a expressão é um identificador simples)
-    auto it = symbolTable.find(expr);
-    if (it != symbolTable.end()) {
-        return it->second.type; 
-    }
+/**
+ * @brief Tipo de "left op right": aritmética dá inteiro, comparação dá
+ *        booleano. Texto só pode ser comparado com texto (== e !=).
+ *        Com erro o resultado é VAR_UNDEFINED, para que os nós acima
+ *        não acusem o mesmo problema de novo.
+ */
+static VarType binaryType(SemanticContext& sc, BinaryOp op, VarType left, VarType right, bool& ok) {
+    bool textLeft = left == VAR_TEXTO, textRight = right == VAR_TEXTO;
+    switch (op) {
+        case OP_MAIS:
+        case OP_MENOS:
+        case OP_VEZES:
+        case OP_DIV:
+        case OP_MENOR:
+        case OP_MAIOR:
+        case OP_MENOR_IGUAL:
+        case OP_MAIOR_IGUAL:
+            if (textLeft || textRight) {
+                ok = sc.error("Erro semântico: operador '%s' não se aplica a texto.",
+                              binaryOpText(op));
+                return VAR_UNDEFINED;
+            }
+            return op <= OP_DIV ? VAR_INTEIRO : VAR_BOOLEANO;
 
-    // 3) Tentar ver se expr é literal numérico puro (ex.: "123")
-    bool soDigitos = true;
-    for (char c: expr) {
-        if (c != '-' && !isdigit(c)) {
-            soDigitos = false;
-            break;
-        }
-    }
-    if (soDigitos) {
-        return VAR_INTEIRO;
+        case OP_IGUAL_IGUAL:
+        case OP_DIFERENTE:
+            if (textLeft != textRight && left != VAR_UNDEFINED && right != VAR_UNDEFINED) {
+                ok = sc.error("Erro semântico: comparação '%s' entre texto e não texto.",
+                              binaryOpText(op));
+                return VAR_UNDEFINED;
+            }
+            return VAR_BOOLEANO;
     }
+    return VAR_UNDEFINED;
+}
 
-    // 4) Se contém operadores (+, -, *, /, <, etc.) ou parênteses, vamos assumir que é “expressão aritmética”
-    //    e você decide se retorna VAR_INTEIRO ou faz mais heurística
-    if (expr.find('+')!=std::string::npos || expr.find('-')!=std::string::npos
-         || expr.find('*')!=std::string::npos || expr.find('/')!=std::string::npos
-         || expr.find('(')!=std::string::npos || expr.find(')')!=std::string::npos
-         || /* ... <, >, <=, etc. */ false) {
-        // Ex: assumimos que é expressão aritmética => VAR_INTEIRO
-        return VAR_INTEIRO;
+/**
+ * @brief Verificação de tipos de baixo para cima: cada nó é visitado uma
+ *        única vez, depois dos operandos, e o tipo fica guardado em
+ *        Expr::type. Como em printExpr, a espinha esquerda (a+b+c+...)
+ *        usa a pilha sc.spine e só os operandos direitos usam recursão.
+ * @param ok Vira false se algum erro foi acusado na expressão.
+ * @return O tipo da raiz (VAR_UNDEFINED se ela tem erro).
+ */
+static VarType checkExpr(SemanticContext& sc, const Expr* expr, bool& ok) {
+    size_t base = sc.spine.size();
+    while (expr->kind == EXPR_BINARIA || expr->kind == EXPR_PARENTESES) {
+        sc.spine.push_back(expr);
+        expr = expr->left;
     }
 
-    // 5) Se chegou aqui e não bateu nada, retorne UNDEFINED
-    return VAR_UNDEFINED;
-}
+    VarType type = leafType(sc, expr, ok);
+    expr->type = type;
 
+    while (sc.spine.size() > base) {
+        const Expr* node = sc.spine.back();
+        sc.spine.pop_back();
+        if (node->kind == EXPR_BINARIA) {
+            VarType right = checkExpr(sc, node->right, ok);
+            type = binaryType(sc, node->op, type, right, ok);
+        }
+        node->type = type;  // parênteses: o tipo de dentro
+    }
+    return type;
+}
@@ -1,17 +1,65 @@
 #ifndef SEMANTIC_H
 #define SEMANTIC_H
 
+#include <memory>
 #include "ast.h"
+#include "cfg.h"
+#include "diagnostics.h"
 
 /**
  * @brief Executa a análise semântica de todo o programa.
  * 
  * - Verifica declarações duplicadas
- * - Cria tabela de símbolos
+ * - Preenche a tabela de símbolos (program.symbols: tipos, canais PWM),
+ *   que a geração de código usa depois
+ * - Distribui os pinos PWM pelos canais e temporizadores do LEDC (ledc.h)
  * - Valida o uso de cada comando (pinos, pwm, etc.)
+ * - Valida as condições de se/enquanto
  * 
  * @param program Referência ao ASTProgram, populado pelo parser.
+ * @param cfg Grafos de config/repita; os comandos são visitados bloco a
+ *        bloco, na ordem do fonte (inclusive dentro de se/enquanto).
+ * @param diagnostics Recebe todos os erros encontrados (a análise não para
+ *        no primeiro).
+ * @return true se o programa não tem erros semânticos.
  */
-void semanticAnalysis(ASTProgram& program);
+bool semanticAnalysis(ASTProgram& program, const ProgramCfg& cfg, DiagnosticList& diagnostics);
+
+struct SemanticContext;
+
+/**
+ * @brief A mesma análise em etapas: declarações, depois config, depois
+ *        repita, depois finish() (a tabela de símbolos passa de uma para
+ *        a outra). A compilação em streaming analisa cada parte assim que
+ *        o parser a termina, sem esperar o resto do fonte.
+ */
+class SemanticAnalyzer {
+public:
+    SemanticAnalyzer(ASTProgram& program, DiagnosticList& diagnostics);
+    ~SemanticAnalyzer();
+
+    /**
+     * @brief Registra as declarações (e acusa as duplicadas).
+     */
+    bool declarations();
+
+    /**
+     * @brief Verifica os comandos de um grafo (config antes de repita).
+     */
+    bool graph(const ControlFlowGraph& graph);
+
+    /**
+     * @brief Fim do programa: distribui os canais PWM (ledc.h) e acusa os
+     *        pinos que não cabem no ESP32.
+     */
+    bool finish();
+
+private:
+    const ASTProgram& program;
+    std::unique_ptr<SemanticContext> sc;
+
+    SemanticAnalyzer(const SemanticAnalyzer&) = delete;
+    SemanticAnalyzer& operator=(const SemanticAnalyzer&) = delete;
+};
 
 #endif // SEMANTIC_H
@@ -0,0 +1,358 @@
+#include "simdlexer.h"
+#include "parser.tab.h"
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/* -------------------------------------------------
+ * 1) Primitivas vetoriais
+ *
+ * Cada função devolve uma máscara de bits: bit i = 1 se o byte i do
+ * bloco satisfaz a condição. O resto do léxico só usa estas funções,
+ * então o mesmo código serve para AVX2 (32 bytes) e SSE2 (16 bytes).
+ * ------------------------------------------------- */
+#if defined(__AVX2__)
+
+typedef __m256i Block;
+static const size_t BLOCK = 32;
+
+static inline Block loadBlock(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline uint32_t maskOf(Block v) { return (uint32_t)_mm256_movemask_epi8(v); }
+static inline Block eqByte(Block v, char c) { return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)); }
+static inline Block orBlock(Block a, Block b) { return _mm256_or_si256(a, b); }
+static inline Block inRange(Block v, unsigned char lo, unsigned char hi) {
+    // (v - lo) <= (hi - lo), sem sinal
+    Block d = _mm256_sub_epi8(v, _mm256_set1_epi8((char)lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8((char)(hi - lo))), d);
+}
+static inline Block lowerCase(Block v) { return _mm256_or_si256(v, _mm256_set1_epi8(0x20)); }
+
+#elif defined(__SSE2__)
+
+typedef __m128i Block;
+static const size_t BLOCK = 16;
+
+static inline Block loadBlock(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline uint32_t maskOf(Block v) { return (uint32_t)_mm_movemask_epi8(v); }
+static inline Block eqByte(Block v, char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); }
+static inline Block orBlock(Block a, Block b) { return _mm_or_si128(a, b); }
+static inline Block inRange(Block v, unsigned char lo, unsigned char hi) {
+    Block d = _mm_sub_epi8(v, _mm_set1_epi8((char)lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8((char)(hi - lo))), d);
+}
+static inline Block lowerCase(Block v) { return _mm_or_si128(v, _mm_set1_epi8(0x20)); }
+
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#define HAVE_SIMD_BLOCKS 1
+static const uint32_t FULL_MASK = (uint32_t)((1ull << BLOCK) - 1);
+
+static inline uint32_t bitsBelow(unsigned k) { return (uint32_t)((1ull << k) - 1); }
+#endif
+
+const char* simdLexerIsa() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
+
+/* -------------------------------------------------
+ * 2) Classes de caractere (parte escalar e cauda do buffer)
+ * ------------------------------------------------- */
+static inline bool isSpace(unsigned char c) { return c == ' ' || c == '\t' || c == '\r'; }
+static inline bool isDigit(unsigned char c) { return c >= '0' && c <= '9'; }
+static inline bool isIdentStart(unsigned char c) {
+    return (unsigned char)((c | 0x20) - 'a') <= 'z' - 'a' || c == '_';
+}
+static inline bool isIdentChar(unsigned char c) { return isIdentStart(c) || isDigit(c); }
+
+/* -------------------------------------------------
+ * 3) Varreduras em bloco
+ * ------------------------------------------------- */
+
+/**
+ * @brief Pula [ \t\r\n]*, contando as quebras de linha.
+ */
+static const char* skipSpaces(const char* p, const char* end, int& line) {
+#ifdef HAVE_SIMD_BLOCKS
+    while (p + BLOCK <= end) {
+        Block v = loadBlock(p);
+        uint32_t nl = maskOf(eqByte(v, '\n'));
+        uint32_t ws = nl | maskOf(orBlock(orBlock(eqByte(v, ' '), eqByte(v, '\t')), eqByte(v, '\r')));
+        uint32_t other = ~ws & FULL_MASK;
+        if (other == 0) {
+            line += __builtin_popcount(nl);
+            p += BLOCK;
+            continue;
+        }
+        unsigned k = __builtin_ctz(other);
+        line += __builtin_popcount(nl & bitsBelow(k));
+        return p + k;
+    }
+#endif
+    while (p < end) {
+        if (*p == '\n') line++;
+        else if (!isSpace((unsigned char)*p)) break;
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Posição do próximo '\n' (ou `end`): fim de um comentário "//".
+ */
+static const char* findNewline(const char* p, const char* end) {
+#ifdef HAVE_SIMD_BLOCKS
+    while (p + BLOCK <= end) {
+        uint32_t nl = maskOf(eqByte(loadBlock(p), '\n'));
+        if (nl != 0) return p + __builtin_ctz(nl);
+        p += BLOCK;
+    }
+#endif
+    while (p < end && *p != '\n') p++;
+    return p;
+}
+
+/**
+ * @brief Posição da aspa que fecha a string (ou NULL), somando em
+ *        `newlines` as quebras de linha do corpo.
+ */
+static const char* findQuote(const char* p, const char* end, int& newlines) {
+#ifdef HAVE_SIMD_BLOCKS
+    while (p + BLOCK <= end) {
+        Block v = loadBlock(p);
+        uint32_t q = maskOf(eqByte(v, '"'));
+        uint32_t nl = maskOf(eqByte(v, '\n'));
+        if (q != 0) {
+            unsigned k = __builtin_ctz(q);
+            newlines += __builtin_popcount(nl & bitsBelow(k));
+            return p + k;
+        }
+        newlines += __builtin_popcount(nl);
+        p += BLOCK;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == '"') return p;
+        if (*p == '\n') newlines++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Fim de [a-zA-Z0-9_]*
+ */
+static const char* skipIdentChars(const char* p, const char* end) {
+#ifdef HAVE_SIMD_BLOCKS
+    while (p + BLOCK <= end) {
+        Block v = loadBlock(p);
+        Block ok = orBlock(orBlock(inRange(lowerCase(v), 'a', 'z'), inRange(v, '0', '9')),
+                           eqByte(v, '_'));
+        uint32_t other = ~maskOf(ok) & FULL_MASK;
+        if (other != 0) return p + __builtin_ctz(other);
+        p += BLOCK;
+    }
+#endif
+    while (p < end && isIdentChar((unsigned char)*p)) p++;
+    return p;
+}
+
+/**
+ * @brief Fim de [0-9]*
+ */
+static const char* skipDigits(const char* p, const char* end) {
+#ifdef HAVE_SIMD_BLOCKS
+    while (p + BLOCK <= end) {
+        uint32_t other = ~maskOf(inRange(loadBlock(p), '0', '9')) & FULL_MASK;
+        if (other != 0) return p + __builtin_ctz(other);
+        p += BLOCK;
+    }
+#endif
+    while (p < end && isDigit((unsigned char)*p)) p++;
+    return p;
+}
+
+/* -------------------------------------------------
+ * 4) Palavras reservadas (as mesmas regras de lexer.l)
+ * ------------------------------------------------- */
+struct Keyword {
+    const char* text;
+    unsigned char length;
+    int kind;
+    int intval;
+};
+
+static const Keyword KEYWORDS[] = {
+    { "var",            3,  VAR,             0 },
+    { "inteiro",        7,  TIPO_INTEIRO,    0 },
+    { "texto",          5,  TIPO_TEXTO,      0 },
+    { "booleano",       8,  TIPO_BOOLEANO,   0 },
+    { "config",         6,  CONFIG,          0 },
+    { "fim",            3,  FIM,             0 },
+    { "repita",         6,  REPITA,          0 },
+    { "configurar",     10, CONFIGURAR,      0 },
+    { "como",           4,  COMO,            0 },
+    { "saida",          5,  DIRECAO,         0 },
+    { "entrada",        7,  DIRECAO,         0 },
+    { "configurarPWM",  13, CONFIGURAR_PWM,  0 },
+    { "ajustarPWM",     10, AJUSTAR_PWM,     0 },
+    { "conectarWifi",   12, CONECTAR_WIFI,   0 },
+    { "enviarHTTP",     10, ENVIAR_HTTP,     0 },
+    { "escreverSerial", 14, ESCREVER_SERIAL, 0 },
+    { "lerSerial",      9,  LER_SERIAL,      0 },
+    { "lerDigital",     10, LER_DIGITAL,     0 },
+    { "lerAnalogico",   12, LER_ANALOGICO,   0 },
+    { "se",             2,  SE,              0 },
+    { "entao",          5,  ENTAO,           0 },
+    { "enquanto",       8,  ENQUANTO,        0 },
+    { "esperar",        7,  ESPERAR,         0 },
+    { "ligar",          5,  LIGAR,           1 },
+    { "desligar",       8,  DESLIGAR,        0 },
+    { "com",            3,  COM,             0 },
+    { "frequencia",     10, FREQUENCIA,      0 },
+    { "resolucao",      9,  RESOLUCAO,       0 },
+    { "valor",          5,  VALOR,           0 },
+};
+
+static const size_t KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+static const size_t KEYWORD_MAX_LEN = 14;
+
+/**
+ * @brief Índice por (tamanho, primeira letra): no máximo 2 memcmp por lexema.
+ */
+struct KeywordIndex {
+    unsigned char first[KEYWORD_MAX_LEN + 1][128];   // índice+1 em KEYWORDS, 0 = nenhum
+    unsigned char second[KEYWORD_MAX_LEN + 1][128];  // colisão ("entrada"/"esperar")
+
+    KeywordIndex() {
+        memset(first, 0, sizeof(first));
+        memset(second, 0, sizeof(second));
+        for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+            const Keyword& k = KEYWORDS[i];
+            unsigned char c = (unsigned char)k.text[0];
+            if (first[k.length][c] == 0) first[k.length][c] = (unsigned char)(i + 1);
+            else second[k.length][c] = (unsigned char)(i + 1);
+        }
+    }
+};
+
+static const KeywordIndex keywordIndex;
+
+static const Keyword* findKeyword(const char* s, size_t n) {
+    unsigned char c = (unsigned char)s[0];
+    if (n > KEYWORD_MAX_LEN || c >= 128) return NULL;
+    unsigned char i = keywordIndex.first[n][c];
+    if (i != 0 && memcmp(KEYWORDS[i - 1].text, s, n) == 0) return &KEYWORDS[i - 1];
+    i = keywordIndex.second[n][c];
+    if (i != 0 && memcmp(KEYWORDS[i - 1].text, s, n) == 0) return &KEYWORDS[i - 1];
+    return NULL;
+}
+
+/**
+ * @brief O mesmo valor de atoi(yytext) no glibc ((int)strtol, que satura
+ *        em LONG_MAX), sem depender de um NUL após o número.
+ */
+static int digitsToInt(const char* p, const char* end) {
+    long value = 0;
+    for (; p < end; p++) {
+        int d = *p - '0';
+        if (value > (LONG_MAX - d) / 10) {
+            value = LONG_MAX;
+            break;
+        }
+        value = value * 10 + d;
+    }
+    return (int)value;
+}
+
+/* -------------------------------------------------
+ * 5) O léxico
+ * ------------------------------------------------- */
+void SimdLexer::next(Token& tok) {
+    for (;;) {
+        cur = skipSpaces(cur, limit, line);
+        // "//".* : ignora até o fim da linha (o '\n' fica para skipSpaces)
+        if (cur + 1 < limit && cur[0] == '/' && cur[1] == '/') {
+            cur = findNewline(cur + 2, limit);
+            continue;
+        }
+        break;
+    }
+
+    tok.text = cur;
+    tok.intval = 0;
+    if (cur >= limit) {
+        tok.kind = 0;
+        tok.length = 0;
+        tok.line = line;
+        return;
+    }
+
+    const char* start = cur;
+    unsigned char c = (unsigned char)*cur;
+    int kind;
+
+    if (isIdentStart(c)) {
+        cur = skipIdentChars(cur + 1, limit);
+        size_t n = (size_t)(cur - start);
+        const Keyword* kw = findKeyword(start, n);
+        if (kw != NULL) {
+            kind = kw->kind;
+            tok.intval = kw->intval;
+        } else if (n == 3 && memcmp(start, "sen", 3) == 0 && limit - cur >= 3
+                   && memcmp(cur, "\xc3\xa3o", 3) == 0) {
+            // "senão" (UTF-8): a regra do flex é mais longa que "sen"
+            cur += 3;
+            kind = SENAO;
+        } else {
+            kind = IDENTIFICADOR;
+        }
+    } else if (isDigit(c)) {
+        cur = skipDigits(cur + 1, limit);
+        kind = NUMERO;
+        tok.intval = digitsToInt(start, cur);
+    } else if (c == '"') {
+        int newlines = 0;
+        const char* close = findQuote(cur + 1, limit, newlines);
+        if (close != NULL) {
+            cur = close + 1;
+            line += newlines;
+            kind = STRING_LIT;
+        } else {
+            cur++;          // sem aspa final: o flex casa só o '"' com "."
+            kind = ERRO;
+        }
+    } else {
+        char next = cur + 1 < limit ? cur[1] : '\0';
+        cur++;
+        switch (c) {
+            case '=': if (next == '=') { cur++; kind = IGUAL_IGUAL; } else kind = IGUAL; break;
+            case '!': if (next == '=') { cur++; kind = DIFERENTE; } else kind = ERRO; break;
+            case '<': if (next == '=') { cur++; kind = MENOR_IGUAL; } else kind = MENOR; break;
+            case '>': if (next == '=') { cur++; kind = MAIOR_IGUAL; } else kind = MAIOR; break;
+            case ':': kind = DOIS_PONTOS; break;
+            case ';': kind = PONTO_VIRGULA; break;
+            case '+': kind = MAIS; break;
+            case '-': kind = MENOS; break;
+            case '*': kind = VEZES; break;
+            case '/': kind = DIV; break;
+            case '(': kind = '('; break;
+            case ')': kind = ')'; break;
+            case ',': kind = VIRGULA; break;
+            default:  kind = ERRO; break;
+        }
+    }
+
+    tok.kind = kind;
+    tok.length = (uint32_t)(cur - start);
+    tok.line = line;
+}
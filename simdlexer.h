@@ -0,0 +1,43 @@
+#ifndef SIMDLEXER_H
+#define SIMDLEXER_H
+
+#include <stddef.h>
+#include "lextoken.h"
+
+/**
+ * @brief Léxico escrito à mão, alternativo ao gerado pelo flex.
+ *
+ * Reconhece exatamente a mesma linguagem de lexer.l (mesmos tokens,
+ * mesmos lexemas e mesmos números de linha), mas pula espaços,
+ * comentários "//" e o corpo de strings em blocos de 16 bytes (SSE2)
+ * ou 32 bytes (AVX2, se compilado com -mavx2), e classifica os
+ * caracteres de identificadores e números da mesma forma.
+ *
+ * Não aloca e não escreve no buffer: pode rodar sobre um mmap somente
+ * leitura e sobre qualquer fatia [begin, end) que comece fora de
+ * string/comentário.
+ */
+class SimdLexer {
+public:
+    SimdLexer(const char* begin, const char* end, int firstLine = 1)
+        : cur(begin), limit(end), line(firstLine) {}
+
+    /**
+     * @brief Lê o próximo token. Ao fim da entrada, tok.kind == 0.
+     */
+    void next(Token& tok);
+
+    int currentLine() const { return line; }
+
+private:
+    const char* cur;
+    const char* limit;
+    int line;
+};
+
+/**
+ * @brief Nome do conjunto de instruções usado ("avx2", "sse2" ou "escalar").
+ */
+const char* simdLexerIsa();
+
+#endif // SIMDLEXER_H
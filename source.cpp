@@ -0,0 +1,117 @@
+#include "source.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool SourceBuffer::load(const std::string& path) {
+    release();
+    name = path;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        // FIFO, dispositivo etc.: sem mmap
+        FILE* in = fdopen(fd, "rb");
+        bool ok = in != NULL && loadStream(in, path);
+        if (in != NULL) fclose(in); else close(fd);
+        return ok;
+    }
+
+    size_t fileSize = (size_t)st.st_size;
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t slack = fileSize % pageSize;
+
+    // O resto da última página é preenchido com zeros pelo kernel:
+    // se couberem os dois NUL, o arquivo mapeado já serve de buffer.
+    if (fileSize > 0 && slack != 0 && slack <= pageSize - 2) {
+        void* p = mmap(NULL, fileSize + 2, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, fileSize + 2, MADV_SEQUENTIAL);
+            close(fd);
+            data = (char*)p;
+            size = fileSize;
+            mapLength = fileSize + 2;
+            return true;
+        }
+    }
+
+    // Sem folga (ou mmap falhou): um único read() para um buffer
+    data = (char*)malloc(fileSize + 2);
+    if (data == NULL) {
+        close(fd);
+        return false;
+    }
+    size_t done = 0;
+    while (done < fileSize) {
+        ssize_t n = read(fd, data + done, fileSize - done);
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    close(fd);
+    size = done;
+    data[size] = data[size + 1] = '\0';
+    return true;
+}
+
+bool SourceBuffer::loadStream(FILE* in, const std::string& streamName) {
+    release();
+    name = streamName;
+
+    size_t capacity = 64 * 1024;
+    data = (char*)malloc(capacity);
+    if (data == NULL) {
+        return false;
+    }
+    size_t n;
+    while ((n = fread(data + size, 1, capacity - size - 2, in)) > 0) {
+        size += n;
+        if (capacity - size - 2 == 0) {
+            capacity *= 2;
+            char* bigger = (char*)realloc(data, capacity);
+            if (bigger == NULL) {
+                release();
+                return false;
+            }
+            data = bigger;
+        }
+    }
+    data[size] = data[size + 1] = '\0';
+    return !ferror(in);
+}
+
+bool SourceBuffer::loadText(const char* text, size_t length, const std::string& textName) {
+    release();
+    name = textName;
+    data = (char*)malloc(length + 2);
+    if (data == NULL) {
+        return false;
+    }
+    memcpy(data, text, length);
+    size = length;
+    data[size] = data[size + 1] = '\0';
+    return true;
+}
+
+void SourceBuffer::release() {
+    if (data != NULL) {
+        if (mapLength > 0) {
+            munmap(data, mapLength);
+        } else {
+            free(data);
+        }
+    }
+    data = NULL;
+    size = 0;
+    mapLength = 0;
+}
@@ -0,0 +1,49 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string>
+
+/**
+ * @brief Texto-fonte de um programa, pronto para yy_scan_buffer().
+ *
+ * O flex exige que o buffer termine com dois bytes NUL e que seja
+ * gravável (ele escreve um NUL temporário após cada token). Arquivos
+ * comuns são mapeados com mmap(MAP_PRIVATE): o léxico lê direto do
+ * page cache e o kernel só copia as páginas em que o flex escreve.
+ * Quando não há folga na última página para os dois NUL (ou a entrada
+ * é um pipe), o conteúdo é lido para um buffer alocado.
+ */
+struct SourceBuffer {
+    char* data;        // texto + 2 bytes NUL
+    size_t size;       // tamanho do texto (sem os NUL)
+    size_t mapLength;  // > 0 se veio de mmap
+    std::string name;  // caminho (ou "<stdin>")
+
+    SourceBuffer() : data(NULL), size(0), mapLength(0) {}
+    ~SourceBuffer() { release(); }
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    /**
+     * @brief Abre `path` (mmap sempre que possível).
+     * @return false se o arquivo não puder ser lido.
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Lê todo o conteúdo de um FILE* (ex.: stdin).
+     */
+    bool loadStream(FILE* in, const std::string& streamName);
+
+    /**
+     * @brief Copia um texto que já está em memória (uso como biblioteca).
+     */
+    bool loadText(const char* text, size_t length, const std::string& textName);
+
+    void release();
+};
+
+#endif // SOURCE_H
@@ -0,0 +1,129 @@
+#include "symtab.h"
+#include <limits.h>
+
+PinMode pinModeFromText(std::string_view text) {
+    return text == "entrada" ? PINO_ENTRADA : PINO_SAIDA;
+}
+
+const char* pinModeName(PinMode mode) {
+    switch (mode) {
+        case PINO_SAIDA:   return "saida";
+        case PINO_ENTRADA: return "entrada";
+        default:           return "-";
+    }
+}
+
+IntWidth intWidthFor(int32_t lo, int32_t hi) {
+    if (lo >= 0) {
+        if (hi <= UINT8_MAX) return INT_WIDTH_U8;
+        if (hi <= UINT16_MAX) return INT_WIDTH_U16;
+        return INT_WIDTH_32;
+    }
+    if (lo >= INT8_MIN && hi <= INT8_MAX) return INT_WIDTH_I8;
+    if (lo >= INT16_MIN && hi <= INT16_MAX) return INT_WIDTH_I16;
+    return INT_WIDTH_32;
+}
+
+const char* intWidthType(IntWidth width) {
+    switch (width) {
+        case INT_WIDTH_U8:  return "uint8_t";
+        case INT_WIDTH_I8:  return "int8_t";
+        case INT_WIDTH_U16: return "uint16_t";
+        case INT_WIDTH_I16: return "int16_t";
+        default:            return "int";
+    }
+}
+
+size_t intWidthBytes(IntWidth width) {
+    switch (width) {
+        case INT_WIDTH_U8:
+        case INT_WIDTH_I8:  return 1;
+        case INT_WIDTH_U16:
+        case INT_WIDTH_I16: return 2;
+        default:            return 4;  // int do ESP32
+    }
+}
+
+void SymbolTable::clear() {
+    types.clear();
+    modes.clear();
+    channels.clear();
+    freqs.clear();
+    resols.clear();
+    pwmLines.clear();
+    clamps.clear();
+    constants.clear();
+    values.clear();
+    widths.clear();
+    pwmPins = 0;
+    clampPins = 0;
+    constantVars = 0;
+}
+
+/**
+ * @brief Garante uma entrada para `id` em todos os vetores.
+ */
+void SymbolTable::reserve(SymbolId id) {
+    if (id < types.size()) return;
+    size_t n = (size_t)id + 1;
+    types.resize(n, VAR_UNDEFINED);
+    modes.resize(n, PINO_NENHUM);
+    channels.resize(n, NO_PWM_CHANNEL);
+    freqs.resize(n, 0);
+    resols.resize(n, 0);
+    pwmLines.resize(n, 0);
+    clamps.resize(n, 0);
+    constants.resize(n, 0);
+    values.resize(n, 0);
+    widths.resize(n, INT_WIDTH_32);
+}
+
+void SymbolTable::declare(SymbolId id, VarType type, PinMode mode) {
+    reserve(id);
+    types[id] = (uint8_t)type;
+    modes[id] = mode;
+}
+
+bool SymbolTable::addPwm(SymbolId id, int freq, int resol, int line) {
+    reserve(id);
+    if (channels[id] != NO_PWM_CHANNEL) return false;
+    channels[id] = (int32_t)pwmPins++;
+    freqs[id] = freq;
+    resols[id] = resol;
+    pwmLines[id] = line;
+    return true;
+}
+
+int SymbolTable::pwmMaxDuty(SymbolId id) const {
+    int resol = resols[id];
+    if (resol <= 0) return 0;
+    if (resol >= 31) return INT_MAX;
+    return (1 << resol) - 1;
+}
+
+void SymbolTable::setDutyClamp(SymbolId id) {
+    reserve(id);
+    if (!clamps[id]) clampPins++;
+    clamps[id] = 1;
+}
+
+void SymbolTable::setConstant(SymbolId id, int value) {
+    reserve(id);
+    if (!constants[id]) constantVars++;
+    constants[id] = 1;
+    values[id] = value;
+}
+
+void SymbolTable::setIntWidth(SymbolId id, IntWidth width) {
+    reserve(id);
+    widths[id] = width;
+}
+
+size_t SymbolTable::narrowedBytes() const {
+    size_t saved = 0;
+    for (SymbolId id = 0; id < size(); id++) {
+        if (types[id] != VAR_INTEIRO || constants[id]) continue;
+        saved += intWidthBytes(INT_WIDTH_32) - intWidthBytes((IntWidth)widths[id]);
+    }
+    return saved;
+}
@@ -0,0 +1,151 @@
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+#include "interner.h"
+
+/* -------------------------------------------------
+ * 1) Tipo de variável
+ * ------------------------------------------------- */
+enum VarType {
+    VAR_INTEIRO,
+    VAR_TEXTO,
+    VAR_BOOLEANO,
+    VAR_UNDEFINED
+};
+
+/* -------------------------------------------------
+ * 2) Modo de pino
+ * ------------------------------------------------- */
+enum PinMode : uint8_t {
+    PINO_NENHUM,   // nunca configurado
+    PINO_SAIDA,    // "saida"   -> OUTPUT
+    PINO_ENTRADA   // "entrada" -> INPUT
+};
+
+/**
+ * @brief Modo de "configurar ... como <texto>" ("entrada" ou "saida";
+ *        qualquer outro texto vale como saída, como sempre foi).
+ */
+PinMode pinModeFromText(std::string_view text);
+
+/**
+ * @brief Texto do modo, para traces e dumps ("saida", "entrada", "-").
+ */
+const char* pinModeName(PinMode mode);
+
+/* -------------------------------------------------
+ * 3) Tipo C++ de um inteiro
+ * ------------------------------------------------- */
+enum IntWidth : uint8_t {
+    INT_WIDTH_32,   // int (sem faixa conhecida)
+    INT_WIDTH_U8,   // uint8_t:  0..255
+    INT_WIDTH_I8,   // int8_t:   -128..127
+    INT_WIDTH_U16,  // uint16_t: 0..65535
+    INT_WIDTH_I16   // int16_t:  -32768..32767
+};
+
+/**
+ * @brief Menor tipo em que cabe todo valor de [lo, hi].
+ */
+IntWidth intWidthFor(int32_t lo, int32_t hi);
+
+/**
+ * @brief Nome do tipo em C++ ("int", "uint8_t", ...) e o seu tamanho.
+ */
+const char* intWidthType(IntWidth width);
+size_t intWidthBytes(IntWidth width);
+
+/* -------------------------------------------------
+ * 4) Tabela de símbolos
+ * ------------------------------------------------- */
+const int NO_PWM_CHANNEL = -1;
+
+/**
+ * @brief Tabela de símbolos da compilação: a análise semântica preenche,
+ *        a geração de código só lê.
+ *
+ * O léxico já resolveu cada nome para um SymbolId denso (StringInterner),
+ * então a tabela não tem chave: cada atributo é um vetor indexado pelo ID
+ * (estrutura de vetores), e uma consulta é um acesso a vetor, sem hash e
+ * sem comparar texto. Um ID que não é variável declarada fica com
+ * VAR_UNDEFINED.
+ */
+class SymbolTable {
+public:
+    SymbolTable() : pwmPins(0), clampPins(0), constantVars(0) {}
+
+    /**
+     * @brief Esquece todos os símbolos (reuso entre compilações).
+     */
+    void clear();
+
+    /* Declarações */
+    void declare(SymbolId id, VarType type, PinMode mode);
+    bool declared(SymbolId id) const { return type(id) != VAR_UNDEFINED; }
+    VarType type(SymbolId id) const {
+        return id < types.size() ? (VarType)types[id] : VAR_UNDEFINED;
+    }
+    PinMode pinMode(SymbolId id) const {  // modo da declaração (PINO_NENHUM se não há)
+        return id < modes.size() ? (PinMode)modes[id] : PINO_NENHUM;
+    }
+
+    /* PWM: canal, frequência e resolução do primeiro configurarPWM do
+       pino; o canal começa com a ordem no fonte e o alocador (ledc.h)
+       troca pelo canal do LEDC */
+    bool addPwm(SymbolId id, int freq, int resol, int line);  // false se já tinha
+    void setPwmChannel(SymbolId id, int channel) { channels[id] = channel; }
+    bool hasPwm(SymbolId id) const {
+        return id < channels.size() && channels[id] != NO_PWM_CHANNEL;
+    }
+    int pwmChannel(SymbolId id) const { return channels[id]; }
+    int pwmFreq(SymbolId id) const { return freqs[id]; }
+    int pwmResol(SymbolId id) const { return resols[id]; }
+    int pwmLine(SymbolId id) const { return pwmLines[id]; }  // linha do configurarPWM
+    int pwmMaxDuty(SymbolId id) const;  // 2^resol - 1 (limitado a 0..INT_MAX)
+    size_t pwmCount() const { return pwmPins; }
+
+    /* Pinos com algum ajustarPWM que precisa limitar o valor (ranges.h) */
+    void setDutyClamp(SymbolId id);
+    size_t dutyClampCount() const { return clampPins; }
+
+    /* Constantes (constprop.h): variável que nunca muda de valor */
+    void setConstant(SymbolId id, int value);
+    bool isConstant(SymbolId id) const { return id < constants.size() && constants[id]; }
+    int constValue(SymbolId id) const { return values[id]; }
+    size_t constantCount() const { return constantVars; }
+
+    /* Tipo C++ de cada inteiro (ranges.h); INT_WIDTH_32 sem análise */
+    void setIntWidth(SymbolId id, IntWidth width);
+    IntWidth intWidth(SymbolId id) const {
+        return id < widths.size() ? (IntWidth)widths[id] : INT_WIDTH_32;
+    }
+    size_t narrowedBytes() const;  // RAM a menos nas globais inteiras (sem os constexpr)
+
+    /**
+     * @brief IDs cobertos (percorrer 0..size()-1 dá a ordem dos nomes).
+     */
+    SymbolId size() const { return (SymbolId)types.size(); }
+
+private:
+    std::vector<uint8_t> types;     // VarType
+    std::vector<uint8_t> modes;     // PinMode
+    std::vector<int32_t> channels;  // NO_PWM_CHANNEL se o pino não tem PWM
+    std::vector<int32_t> freqs;
+    std::vector<int32_t> resols;
+    std::vector<int32_t> pwmLines;
+    std::vector<uint8_t> clamps;    // 1 se o pino tem ajustarPWM limitado
+    std::vector<uint8_t> constants; // 1 se o valor é fixo (em `values`)
+    std::vector<int32_t> values;
+    std::vector<uint8_t> widths;    // IntWidth
+    size_t pwmPins;
+    size_t clampPins;
+    size_t constantVars;
+
+    void reserve(SymbolId id);
+};
+
+#endif // SYMTAB_H
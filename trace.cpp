@@ -0,0 +1,133 @@
+#include "trace.h"
+#include <stdarg.h>
+#include <string.h>
+
+TraceConfig traceConfig = { TRACE_OFF, 0 };
+
+static const size_t TRACE_BUFFER_SIZE = 64 * 1024;
+static const size_t TRACE_LINE_MAX    = 512;
+
+// Modo e destino: escritos só em traceSetup(), antes da compilação
+static TraceSinkMode traceMode = TRACE_SINK_STREAM;
+static FILE* traceSink = NULL;
+
+/**
+ * @brief Buffer do trace, um por thread (o front end é reentrante e
+ *        cada thread compila o seu programa). Cada linha é formatada
+ *        direto aqui; o destino só é tocado quando o buffer enche
+ *        (modo fluxo), em traceFlush() ou quando a thread termina.
+ */
+struct TraceBuffer {
+    char data[TRACE_BUFFER_SIZE];
+    size_t pos;          // próxima posição livre
+    bool wrapped;        // modo anel: já deu a volta?
+
+    TraceBuffer() : pos(0), wrapped(false) {}
+    ~TraceBuffer();      // descarrega o que sobrou (inclusive em exit(1))
+};
+
+static thread_local TraceBuffer traceBuf;
+
+void traceSetup(int level, unsigned categories, TraceSinkMode mode, FILE* sink) {
+    traceFlush();
+    traceConfig.level = level;
+    traceConfig.mask = categories;
+    traceMode = mode;
+    traceSink = sink;
+}
+
+unsigned traceParseCategories(const char* list) {
+    unsigned mask = 0;
+    const char* p = list;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+
+        if      (len == 3 && strncmp(p, "lex", len) == 0)      mask |= TRACE_LEX;
+        else if (len == 5 && strncmp(p, "parse", len) == 0)    mask |= TRACE_PARSE;
+        else if (len == 8 && strncmp(p, "semantic", len) == 0) mask |= TRACE_SEMANTIC;
+        else if (len == 7 && strncmp(p, "codegen", len) == 0)  mask |= TRACE_CODEGEN;
+        else if (len == 3 && strncmp(p, "all", len) == 0)      mask |= TRACE_ALL;
+        else return 0;
+
+        p += len;
+        if (*p == ',') p++;
+    }
+    return mask;
+}
+
+static const char* categoryTag(TraceCategory cat) {
+    switch (cat) {
+        case TRACE_LEX:      return "lex";
+        case TRACE_PARSE:    return "parse";
+        case TRACE_SEMANTIC: return "semantic";
+        case TRACE_CODEGEN:  return "codegen";
+        default:             return "trace";
+    }
+}
+
+void traceWrite(TraceCategory cat, const char* fmt, ...) {
+    char line[TRACE_LINE_MAX];
+    int n = snprintf(line, sizeof(line), "[%s] ", categoryTag(cat));
+
+    va_list args;
+    va_start(args, fmt);
+    int m = vsnprintf(line + n, sizeof(line) - n - 1, fmt, args);
+    va_end(args);
+
+    size_t len = (size_t)n + (m < 0 ? 0 : (size_t)m);
+    if (len > sizeof(line) - 2) len = sizeof(line) - 2; // linha truncada
+    line[len++] = '\n';
+
+    TraceBuffer& tb = traceBuf;
+    if (traceMode == TRACE_SINK_STREAM) {
+        if (tb.pos + len > TRACE_BUFFER_SIZE) traceFlush();
+        memcpy(tb.data + tb.pos, line, len);
+        tb.pos += len;
+        return;
+    }
+
+    // Modo anel: sobrescreve os bytes mais antigos
+    size_t first = TRACE_BUFFER_SIZE - tb.pos;
+    if (len < first) first = len;
+    memcpy(tb.data + tb.pos, line, first);
+    memcpy(tb.data, line + first, len - first);
+    tb.pos = (tb.pos + len) % TRACE_BUFFER_SIZE;
+    if (first < len || tb.pos == 0) tb.wrapped = true;
+}
+
+static void flushBuffer(TraceBuffer& tb) {
+    if (traceSink == NULL) {
+        tb.pos = 0;
+        tb.wrapped = false;
+        return;
+    }
+
+    if (traceMode == TRACE_SINK_RING && tb.wrapped) {
+        // Descarta a primeira linha (parcialmente sobrescrita)
+        const char* start = tb.data + tb.pos;
+        const char* end = tb.data + TRACE_BUFFER_SIZE;
+        const char* nl = (const char*)memchr(start, '\n', end - start);
+        if (nl != NULL) {
+            fwrite(nl + 1, 1, end - (nl + 1), traceSink);
+            fwrite(tb.data, 1, tb.pos, traceSink);
+        } else {
+            nl = (const char*)memchr(tb.data, '\n', tb.pos);
+            if (nl != NULL)
+                fwrite(nl + 1, 1, tb.data + tb.pos - (nl + 1), traceSink);
+        }
+    } else if (tb.pos > 0) {
+        fwrite(tb.data, 1, tb.pos, traceSink);
+    }
+    fflush(traceSink);
+    tb.pos = 0;
+    tb.wrapped = false;
+}
+
+void traceFlush() {
+    flushBuffer(traceBuf);
+}
+
+TraceBuffer::~TraceBuffer() {
+    flushBuffer(*this);
+}
@@ -0,0 +1,92 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+/* -------------------------------------------------
+ * 1) Níveis de verbosidade
+ * ------------------------------------------------- */
+enum TraceLevel {
+    TRACE_OFF   = 0,   // nenhum trace (padrão)
+    TRACE_INFO  = 1,   // eventos de alto nível (declarações, blocos, comandos)
+    TRACE_DEBUG = 2    // tudo, inclusive cada token do léxico
+};
+
+/* -------------------------------------------------
+ * 2) Categorias (uma por fase do compilador)
+ * ------------------------------------------------- */
+enum TraceCategory {
+    TRACE_LEX      = 1u << 0,
+    TRACE_PARSE    = 1u << 1,
+    TRACE_SEMANTIC = 1u << 2,
+    TRACE_CODEGEN  = 1u << 3,
+    TRACE_ALL      = 0xFu
+};
+
+/* -------------------------------------------------
+ * 3) Modo do destino (sink) do trace
+ * ------------------------------------------------- */
+enum TraceSinkMode {
+    TRACE_SINK_STREAM, // buffer grande, descarregado com fwrite quando enche
+    TRACE_SINK_RING    // anel: guarda só os últimos bytes, descarregados no fim
+};
+
+/**
+ * @brief Configuração global do trace. Só é escrita por traceSetup(),
+ *        antes da compilação; depois disso é apenas lida.
+ */
+struct TraceConfig {
+    int level;          // TraceLevel atual
+    unsigned mask;      // categorias habilitadas (TraceCategory)
+};
+
+extern TraceConfig traceConfig;
+
+/**
+ * @brief Habilita o trace.
+ * @param level Nível máximo a registrar (TRACE_OFF desliga).
+ * @param categories Máscara de TraceCategory.
+ * @param mode Buffer de fluxo ou anel.
+ * @param sink Arquivo de destino (ex.: stderr).
+ */
+void traceSetup(int level, unsigned categories, TraceSinkMode mode, FILE* sink);
+
+/**
+ * @brief Converte uma lista "lex,parse,semantic,codegen" (ou "all") em máscara.
+ * @return A máscara, ou 0 se algum nome for desconhecido.
+ */
+unsigned traceParseCategories(const char* list);
+
+/**
+ * @brief Formata uma linha no buffer do trace (não usar diretamente: use TRACE).
+ */
+void traceWrite(TraceCategory cat, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Descarrega o buffer no destino configurado.
+ */
+void traceFlush();
+
+static inline bool traceEnabled(TraceCategory cat, int level) {
+    return traceConfig.level >= level && (traceConfig.mask & cat) != 0;
+}
+
+/*
+ * TRACE(categoria, nível, formato, ...)
+ *
+ * Compilado sem TRACE_ENABLED (make TRACE=0) o macro some por completo:
+ * nem os argumentos são avaliados. Com TRACE_ENABLED, o custo com o trace
+ * desligado é um único teste de nível/categoria.
+ */
+#ifdef TRACE_ENABLED
+#define TRACE(cat, level, ...)                         \
+    do {                                               \
+        if (traceEnabled((cat), (level)))              \
+            traceWrite((cat), __VA_ARGS__);            \
+    } while (0)
+#else
+#define TRACE(cat, level, ...) do { } while (0)
+#endif
+
+#endif // TRACE_H